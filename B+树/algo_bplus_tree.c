@@ -0,0 +1,1099 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ */
+
+#include "algo_bplus_tree.h"
+#include "algo_avl_tree.h"
+
+
+/**
+ * 默认key比较,key为字符串.
+ */
+static int bptree_keycmp_str(struct bplus_tree *bptree, const void *key_cmp, const void *key_becmp)
+{
+    return strcmp(key_cmp, key_becmp);
+}
+
+/*节点中每个key占用的字节数*/
+static int bplus_tree_key_width(struct bplus_tree *bptree)
+{
+    return (bptree->keysize > 0) ? bptree->keysize : (int)sizeof(void *);
+}
+
+/**
+ * 节点中第i个key,keysize>0时为节点内key数据的地址,否则为保存的key指针.
+ */
+static void *bplus_tree_key(struct bplus_tree *bptree, struct bplus_tree_node *node, int i)
+{
+    if (bptree->keysize > 0)
+        return node->keys + i * bptree->keysize;
+
+    return ((void **)node->keys)[i];
+}
+
+/**
+ * 设置节点中第i个key,key为bplus_tree_key返回的地址或调用者传入的key.
+ */
+static void bplus_tree_key_set(struct bplus_tree *bptree, struct bplus_tree_node *node, int i, const void *key)
+{
+    if (bptree->keysize > 0)
+    {
+        memcpy(node->keys + i * bptree->keysize, key, bptree->keysize);
+    }
+    else
+    {
+        ((void **)node->keys)[i] = (void *)key;
+    }
+}
+
+/**
+ * 把src节点从si开始的n个key移动到dst节点的di位置,可以是同一个节点.
+ */
+static void bplus_tree_key_move(struct bplus_tree *bptree, struct bplus_tree_node *dst, int di, struct bplus_tree_node *src, int si, int n)
+{
+    int width = bplus_tree_key_width(bptree);
+
+    memmove(dst->keys + di * width, src->keys + si * width, n * width);
+}
+
+/**
+ * 申请节点,节点和key数组在同一块空间中.
+ */
+static struct bplus_tree_node *bplus_tree_node_creat(struct bplus_tree *bptree, int leaf)
+{
+    struct bplus_tree_node *node = NULL;
+
+    node = BPLUS_TREE_MALLOC(sizeof(*node) + BPLUS_TREE_ORDER * bplus_tree_key_width(bptree));
+    if (node == NULL)
+        return NULL;
+
+    node->leaf = leaf;
+    node->num = 0;
+    node->prev = NULL;
+    node->next = NULL;
+
+    return node;
+}
+
+/**
+ * 动态创建一个B+树,keysize>0时key复制到节点内,否则只保存key指针.
+ *
+ * @param keysize: >0:key为keysize字节的数据; 0:key为指针,key的内存由调用者管理
+ * @param keycmp: key比较函数,keysize>0时必须指定(memcmp在小端机器上不能按数值比较int等类型),
+ *                keysize为0时NULL按字符串比较
+ * @param valuefree: 删除节点数据时调用,可以为NULL
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct bplus_tree *bplus_tree_creat_key(int keysize, bptree_keycmp keycmp, bptree_value_free valuefree)
+{
+    struct bplus_tree *bptree = NULL;
+
+    if ((keysize < 0) || ((keysize > 0) && (keycmp == NULL)))
+        return NULL;
+
+    bptree = BPLUS_TREE_MALLOC(sizeof(*bptree));
+    if (bptree == NULL)
+        return NULL;
+
+    bptree->num       = 0;
+    bptree->height    = 1;
+    bptree->keysize   = keysize;
+    bptree->keycmp    = (keycmp != NULL) ? keycmp : bptree_keycmp_str;
+    bptree->valuefree = valuefree;
+    bptree->root      = bplus_tree_node_creat(bptree, 1);
+    if (bptree->root == NULL)
+    {
+        BPLUS_TREE_FREE(bptree);
+        return NULL;
+    }
+
+    return bptree;
+}
+
+/**
+ * 动态创建一个只保存key指针的B+树,与bs_tree_creat相同.
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct bplus_tree *bplus_tree_creat(bptree_keycmp keycmp, bptree_value_free valuefree)
+{
+    if (keycmp == NULL)
+        return NULL;
+
+    return bplus_tree_creat_key(0, keycmp, valuefree);
+}
+
+/**
+ * 使用默认 key比较函数(字符串) 动态创建一个B+树.
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct bplus_tree *bplus_tree_creat_default(bptree_value_free valuefree)
+{
+    return bplus_tree_creat_key(0, NULL, valuefree);
+}
+
+/**
+ * 节点中第一个不小于key的位置,二分查找.
+ */
+static int bplus_tree_lower(struct bplus_tree *bptree, struct bplus_tree_node *node, const void *key)
+{
+    int lo = 0, hi = node->num, mid = 0;
+
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (bptree->keycmp(bptree, key, bplus_tree_key(bptree, node, mid)) > 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * 节点中第一个大于key的位置,即内部节点中key所在子树的序号.
+ */
+static int bplus_tree_upper(struct bplus_tree *bptree, struct bplus_tree_node *node, const void *key)
+{
+    int lo = 0, hi = node->num, mid = 0;
+
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (bptree->keycmp(bptree, key, bplus_tree_key(bptree, node, mid)) >= 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * 从根节点查找key所在的叶子节点,记录经过的内部节点和子树序号.
+ *
+ * @param path: 返回各层内部节点,不需要时为NULL
+ * @param idx: 返回各层进入的子树序号
+ * @return 叶子节点
+ */
+static struct bplus_tree_node *bplus_tree_find_leaf(struct bplus_tree *bptree, const void *key, struct bplus_tree_node **path, int *idx)
+{
+    struct bplus_tree_node *node = bptree->root;
+    int h = 0, i = 0;
+
+    while (!node->leaf)
+    {
+        i = bplus_tree_upper(bptree, node, key);
+        if (path != NULL)
+        {
+            path[h] = node;
+            idx[h] = i;
+        }
+        h++;
+        node = node->ptrs[i];
+    }
+
+    return node;
+}
+
+/**
+ * 子树中key最小的叶子节点.
+ */
+static struct bplus_tree_node *bplus_tree_leftmost(struct bplus_tree_node *node)
+{
+    while (!node->leaf)
+    {
+        node = node->ptrs[0];
+    }
+
+    return node;
+}
+
+/**
+ * 在叶子节点的pos位置插入key和value,节点未满.
+ */
+static void bplus_tree_leaf_insert(struct bplus_tree *bptree, struct bplus_tree_node *leaf, int pos, const void *key, void *value)
+{
+    bplus_tree_key_move(bptree, leaf, pos + 1, leaf, pos, leaf->num - pos);
+    memmove(&leaf->ptrs[pos + 1], &leaf->ptrs[pos], (leaf->num - pos) * sizeof(void *));
+    bplus_tree_key_set(bptree, leaf, pos, key);
+    leaf->ptrs[pos] = value;
+    leaf->num++;
+}
+
+/**
+ * 在内部节点的子树i之后插入分隔key和子节点,节点未满.
+ */
+static void bplus_tree_internal_insert(struct bplus_tree *bptree, struct bplus_tree_node *node, int i, const void *key, struct bplus_tree_node *child)
+{
+    bplus_tree_key_move(bptree, node, i + 1, node, i, node->num - i);
+    memmove(&node->ptrs[i + 2], &node->ptrs[i + 1], (node->num - i) * sizeof(void *));
+    bplus_tree_key_set(bptree, node, i, key);
+    node->ptrs[i + 1] = child;
+    node->num++;
+}
+
+/**
+ * 删除内部节点中的第k个key和它右边的子节点.
+ */
+static void bplus_tree_internal_remove(struct bplus_tree *bptree, struct bplus_tree_node *node, int k)
+{
+    bplus_tree_key_move(bptree, node, k, node, k + 1, node->num - k - 1);
+    memmove(&node->ptrs[k + 1], &node->ptrs[k + 2], (node->num - k - 1) * sizeof(void *));
+    node->num--;
+}
+
+/**
+ * 插入key和value,key不能重复.
+ * 叶子节点满时分裂为两个节点,右节点的第一个key插入父节点,父节点满时继续向上分裂,根节点分裂时树高加1.
+ * 需要的新节点在修改树之前全部申请,申请失败时树不变.
+ *
+ * @param bptree: B+树
+ * @param key: 关键值,keysize>0时复制到节点内
+ * @param value: 节点数据
+ *
+ * @return 0:插入成功
+ *        -1:B+树不存在 或 key为空
+ *        -2:节点空间申请失败
+ *        -3:key已经存在
+ */
+int bplus_tree_insert(struct bplus_tree *bptree, void *key, void *value)
+{
+    struct bplus_tree_node *path[BPLUS_TREE_MAX_HEIGHT];
+    int idx[BPLUS_TREE_MAX_HEIGHT];
+    struct bplus_tree_node *nodes[BPLUS_TREE_MAX_HEIGHT + 1]; /*分裂需要的新节点*/
+    struct bplus_tree_node *leaf = NULL;
+    struct bplus_tree_node *right = NULL;
+    struct bplus_tree_node *parent = NULL;
+    struct bplus_tree_node *child = NULL;
+    void *sep = NULL;
+    int h = 0, i = 0, pos = 0, mid = 0, need = 0, used = 0;
+
+    if (bptree == NULL || key == NULL)
+        return -1;
+
+    leaf = bplus_tree_find_leaf(bptree, key, path, idx);
+    pos = bplus_tree_lower(bptree, leaf, key);
+    if ((pos < leaf->num) && (bptree->keycmp(bptree, key, bplus_tree_key(bptree, leaf, pos)) == 0))
+        return -3;
+
+    if (leaf->num < BPLUS_TREE_ORDER)
+    {
+        bplus_tree_leaf_insert(bptree, leaf, pos, key, value);
+        bptree->num++;
+        return 0;
+    }
+
+    /*叶子节点和从下往上连续满的父节点都要分裂,全部满时还需要新的根节点*/
+    need = 1;
+    for (h = bptree->height - 2; (h >= 0) && (path[h]->num == BPLUS_TREE_ORDER); h--)
+    {
+        need++;
+    }
+    if ((h < 0) && (bptree->height < BPLUS_TREE_MAX_HEIGHT))
+    {
+        need++;
+    }
+    else if (h < 0)
+    {
+        return -2;
+    }
+    for (used = 0; used < need; used++)
+    {
+        nodes[used] = bplus_tree_node_creat(bptree, 0);
+        if (nodes[used] == NULL)
+        {
+            while (used-- > 0)
+            {
+                BPLUS_TREE_FREE(nodes[used]);
+            }
+            return -2;
+        }
+    }
+    used = 0;
+
+    /*分裂叶子节点,后一半key移到新节点*/
+    mid = BPLUS_TREE_ORDER / 2;
+    right = nodes[used++];
+    right->leaf = 1;
+    bplus_tree_key_move(bptree, right, 0, leaf, mid, BPLUS_TREE_ORDER - mid);
+    memcpy(right->ptrs, &leaf->ptrs[mid], (BPLUS_TREE_ORDER - mid) * sizeof(void *));
+    right->num = BPLUS_TREE_ORDER - mid;
+    leaf->num = mid;
+
+    right->next = leaf->next;
+    if (leaf->next != NULL)
+    {
+        leaf->next->prev = right;
+    }
+    leaf->next = right;
+    right->prev = leaf;
+
+    if (pos <= mid)
+    {
+        bplus_tree_leaf_insert(bptree, leaf, pos, key, value);
+    }
+    else
+    {
+        bplus_tree_leaf_insert(bptree, right, pos - mid, key, value);
+    }
+    bptree->num++;
+
+    /*逐层向父节点插入分隔key*/
+    sep = bplus_tree_key(bptree, right, 0);
+    child = right;
+    for (h = bptree->height - 2; h >= 0; h--)
+    {
+        parent = path[h];
+        i = idx[h];
+        if (parent->num < BPLUS_TREE_ORDER)
+        {
+            bplus_tree_internal_insert(bptree, parent, i, sep, child);
+            return 0;
+        }
+
+        /*
+         * 父节点满,keys[mid]上移,之后的key和子节点移到新节点.
+         * 上移的key暂存在新节点最后一个不会用到的key位置,父节点插入时移动key不会覆盖它.
+         */
+        right = nodes[used++];
+        bplus_tree_key_set(bptree, right, BPLUS_TREE_ORDER - 1, bplus_tree_key(bptree, parent, mid));
+        bplus_tree_key_move(bptree, right, 0, parent, mid + 1, BPLUS_TREE_ORDER - mid - 1);
+        memcpy(right->ptrs, &parent->ptrs[mid + 1], (BPLUS_TREE_ORDER - mid) * sizeof(void *));
+        right->num = BPLUS_TREE_ORDER - mid - 1;
+        parent->num = mid;
+
+        if (i <= mid)
+        {
+            bplus_tree_internal_insert(bptree, parent, i, sep, child);
+        }
+        else
+        {
+            bplus_tree_internal_insert(bptree, right, i - mid - 1, sep, child);
+        }
+
+        sep = bplus_tree_key(bptree, right, BPLUS_TREE_ORDER - 1);
+        child = right;
+    }
+
+    /*根节点分裂,树高加1*/
+    parent = nodes[used++];
+    bplus_tree_key_set(bptree, parent, 0, sep);
+    parent->ptrs[0] = bptree->root;
+    parent->ptrs[1] = child;
+    parent->num = 1;
+    bptree->root = parent;
+    bptree->height++;
+
+    return 0;
+}
+
+/**
+ * key只保存指针时,内部节点的分隔key就是某个叶子节点中的key指针,删除(或modify替换)的key作为分隔key时
+ * 用其右边子树中最小的key替换,之后原来key的内存可以被valuefree释放.
+ * keysize>0时分隔key是复制的数据,不需要替换.
+ */
+static void bplus_tree_fix_separator(struct bplus_tree *bptree, const void *key)
+{
+    struct bplus_tree_node *node = bptree->root;
+    struct bplus_tree_node *leaf = NULL;
+    int i = 0;
+
+    while (!node->leaf)
+    {
+        i = bplus_tree_upper(bptree, node, key);
+        if ((i > 0) && (bplus_tree_key(bptree, node, i - 1) == key))
+        {
+            leaf = bplus_tree_leftmost(node->ptrs[i]);
+            bplus_tree_key_set(bptree, node, i - 1, bplus_tree_key(bptree, leaf, 0));
+        }
+        node = node->ptrs[i];
+    }
+}
+
+/**
+ * 删除key后节点中key个数少于BPLUS_TREE_MIN_KEYS时,先向左右兄弟节点借一个key,
+ * 兄弟节点也不够时与兄弟节点合并,父节点少一个key,再继续向上调整.根节点只剩一个子节点时树高减1.
+ */
+static void bplus_tree_rebalance(struct bplus_tree *bptree, struct bplus_tree_node **path, int *idx, struct bplus_tree_node *node)
+{
+    struct bplus_tree_node *parent = NULL;
+    struct bplus_tree_node *left = NULL;
+    struct bplus_tree_node *right = NULL;
+    int h = bptree->height - 1, i = 0;
+
+    while ((h > 0) && (node->num < BPLUS_TREE_MIN_KEYS))
+    {
+        parent = path[h - 1];
+        i = idx[h - 1];
+        left = (i > 0) ? parent->ptrs[i - 1] : NULL;
+        right = (i < parent->num) ? parent->ptrs[i + 1] : NULL;
+
+        if ((left != NULL) && (left->num > BPLUS_TREE_MIN_KEYS))
+        {
+            /*向左兄弟借最后一个*/
+            bplus_tree_key_move(bptree, node, 1, node, 0, node->num);
+            if (node->leaf)
+            {
+                memmove(&node->ptrs[1], &node->ptrs[0], node->num * sizeof(void *));
+                bplus_tree_key_set(bptree, node, 0, bplus_tree_key(bptree, left, left->num - 1));
+                node->ptrs[0] = left->ptrs[left->num - 1];
+                bplus_tree_key_set(bptree, parent, i - 1, bplus_tree_key(bptree, node, 0));
+            }
+            else
+            {
+                memmove(&node->ptrs[1], &node->ptrs[0], (node->num + 1) * sizeof(void *));
+                bplus_tree_key_set(bptree, node, 0, bplus_tree_key(bptree, parent, i - 1));
+                node->ptrs[0] = left->ptrs[left->num];
+                bplus_tree_key_set(bptree, parent, i - 1, bplus_tree_key(bptree, left, left->num - 1));
+            }
+            left->num--;
+            node->num++;
+            return;
+        }
+
+        if ((right != NULL) && (right->num > BPLUS_TREE_MIN_KEYS))
+        {
+            /*向右兄弟借第一个*/
+            if (node->leaf)
+            {
+                bplus_tree_key_set(bptree, node, node->num, bplus_tree_key(bptree, right, 0));
+                node->ptrs[node->num] = right->ptrs[0];
+                bplus_tree_key_move(bptree, right, 0, right, 1, right->num - 1);
+                memmove(&right->ptrs[0], &right->ptrs[1], (right->num - 1) * sizeof(void *));
+                bplus_tree_key_set(bptree, parent, i, bplus_tree_key(bptree, right, 0));
+            }
+            else
+            {
+                bplus_tree_key_set(bptree, node, node->num, bplus_tree_key(bptree, parent, i));
+                node->ptrs[node->num + 1] = right->ptrs[0];
+                bplus_tree_key_set(bptree, parent, i, bplus_tree_key(bptree, right, 0));
+                bplus_tree_key_move(bptree, right, 0, right, 1, right->num - 1);
+                memmove(&right->ptrs[0], &right->ptrs[1], right->num * sizeof(void *));
+            }
+            right->num--;
+            node->num++;
+            return;
+        }
+
+        /*合并到左边的节点,统一为把right合并到left*/
+        if (left != NULL)
+        {
+            right = node;
+            i = i - 1;
+        }
+        else
+        {
+            left = node;
+        }
+
+        if (left->leaf)
+        {
+            bplus_tree_key_move(bptree, left, left->num, right, 0, right->num);
+            memcpy(&left->ptrs[left->num], right->ptrs, right->num * sizeof(void *));
+            left->num += right->num;
+            left->next = right->next;
+            if (right->next != NULL)
+            {
+                right->next->prev = left;
+            }
+        }
+        else
+        {
+            /*父节点中的分隔key下移*/
+            bplus_tree_key_set(bptree, left, left->num, bplus_tree_key(bptree, parent, i));
+            bplus_tree_key_move(bptree, left, left->num + 1, right, 0, right->num);
+            memcpy(&left->ptrs[left->num + 1], right->ptrs, (right->num + 1) * sizeof(void *));
+            left->num += right->num + 1;
+        }
+        bplus_tree_internal_remove(bptree, parent, i);
+        BPLUS_TREE_FREE(right);
+
+        node = parent;
+        h--;
+    }
+
+    /*根节点没有key时,唯一的子节点成为根节点*/
+    node = bptree->root;
+    if (!node->leaf && (node->num == 0))
+    {
+        bptree->root = node->ptrs[0];
+        bptree->height--;
+        BPLUS_TREE_FREE(node);
+    }
+}
+
+/**
+ * 删除key.
+ *
+ * @param bptree: B+树
+ * @param key: 删除节点关键值
+ *
+ * @return 0:删除成功
+ *        -1:B+树不存在 或 key为空
+ *        -2:节点不存在
+ */
+int bplus_tree_delete(struct bplus_tree *bptree, void *key)
+{
+    struct bplus_tree_node *path[BPLUS_TREE_MAX_HEIGHT];
+    int idx[BPLUS_TREE_MAX_HEIGHT];
+    struct bplus_tree_node *leaf = NULL;
+    struct bplus_tree_entry entry;
+    int pos = 0;
+
+    if (bptree == NULL || key == NULL)
+        return -1;
+
+    leaf = bplus_tree_find_leaf(bptree, key, path, idx);
+    pos = bplus_tree_lower(bptree, leaf, key);
+    if ((pos >= leaf->num) || (bptree->keycmp(bptree, key, bplus_tree_key(bptree, leaf, pos)) != 0))
+        return -2;
+
+    entry.key = bplus_tree_key(bptree, leaf, pos);
+    entry.value = leaf->ptrs[pos];
+
+    /*key在节点内时,先释放数据再从节点中删除*/
+    if ((bptree->keysize > 0) && (bptree->valuefree != NULL))
+    {
+        bptree->valuefree(&entry);
+    }
+
+    bplus_tree_key_move(bptree, leaf, pos, leaf, pos + 1, leaf->num - pos - 1);
+    memmove(&leaf->ptrs[pos], &leaf->ptrs[pos + 1], (leaf->num - pos - 1) * sizeof(void *));
+    leaf->num--;
+    bptree->num--;
+
+    bplus_tree_rebalance(bptree, path, idx, leaf);
+
+    /*key只保存指针时,不再引用该key后再释放*/
+    if (bptree->keysize == 0)
+    {
+        if (pos == 0)
+        {
+            bplus_tree_fix_separator(bptree, entry.key);
+        }
+        if (bptree->valuefree != NULL)
+        {
+            bptree->valuefree(&entry);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * 修改key对应的value,会先对原来的key和value调用valuefree.
+ * keysize为0时与bs_tree_modify相同,节点改为保存传入的key,原来的key可以在valuefree中释放.
+ *
+ * @param bptree: B+树
+ * @param key: 修改节点关键值
+ * @param value: 修改节点数据
+ *
+ * @return 0:修改成功
+ *        -1:B+树不存在 或 key为空
+ *        -2:节点不存在
+ */
+int bplus_tree_modify(struct bplus_tree *bptree, void *key, void *value)
+{
+    struct bplus_tree_node *leaf = NULL;
+    struct bplus_tree_entry entry;
+    int pos = 0;
+
+    if (bptree == NULL || key == NULL)
+        return -1;
+
+    leaf = bplus_tree_find_leaf(bptree, key, NULL, NULL);
+    pos = bplus_tree_lower(bptree, leaf, key);
+    if ((pos >= leaf->num) || (bptree->keycmp(bptree, key, bplus_tree_key(bptree, leaf, pos)) != 0))
+        return -2;
+
+    entry.key = bplus_tree_key(bptree, leaf, pos);
+    entry.value = leaf->ptrs[pos];
+    leaf->ptrs[pos] = value;
+
+    /*key只保存指针时,换成传入的key,分隔key引用原来的key时一起替换*/
+    if (bptree->keysize == 0)
+    {
+        bplus_tree_key_set(bptree, leaf, pos, key);
+        if (pos == 0)
+        {
+            bplus_tree_fix_separator(bptree, entry.key);
+        }
+    }
+
+    if (bptree->valuefree != NULL)
+    {
+        bptree->valuefree(&entry);
+    }
+
+    return 0;
+}
+
+/**
+ * 根据key查找节点数据.
+ *
+ * @param bptree: B+树
+ * @param key: 查找节点关键值
+ * @param value: 返回节点数据,不需要时为NULL
+ *
+ * @return 0:查找成功
+ *        -1:B+树不存在 或 key为空 或 树为空
+ *        -2:节点不存在
+ */
+int bplus_tree_search(struct bplus_tree *bptree, void *key, void **value)
+{
+    struct bplus_tree_node *leaf = NULL;
+    int pos = 0;
+
+    if (bptree == NULL || key == NULL || BPTREE_IS_EMPTY(bptree))
+        return -1;
+
+    leaf = bplus_tree_find_leaf(bptree, key, NULL, NULL);
+    pos = bplus_tree_lower(bptree, leaf, key);
+    if ((pos >= leaf->num) || (bptree->keycmp(bptree, key, bplus_tree_key(bptree, leaf, pos)) != 0))
+        return -2;
+
+    if (value != NULL)
+    {
+        *value = leaf->ptrs[pos];
+    }
+
+    return 0;
+}
+
+/**
+ * 查找最小key的节点数据.
+ *
+ * @return NULL:树为空
+ */
+void * bplus_tree_search_min(struct bplus_tree *bptree)
+{
+    struct bplus_tree_node *leaf = NULL;
+
+    if (bptree == NULL || BPTREE_IS_EMPTY(bptree))
+        return NULL;
+
+    leaf = bplus_tree_leftmost(bptree->root);
+
+    return leaf->ptrs[0];
+}
+
+/**
+ * 查找最大key的节点数据.
+ *
+ * @return NULL:树为空
+ */
+void * bplus_tree_search_max(struct bplus_tree *bptree)
+{
+    struct bplus_tree_node *node = NULL;
+
+    if (bptree == NULL || BPTREE_IS_EMPTY(bptree))
+        return NULL;
+
+    node = bptree->root;
+    while (!node->leaf)
+    {
+        node = node->ptrs[node->num];
+    }
+
+    return node->ptrs[node->num - 1];
+}
+
+/**
+ * 更新遍历位置的key/value,当前叶子节点遍历完时移到下一个叶子节点.
+ *
+ * @return 0:位置有效
+ *        -1:遍历结束
+ */
+static int bplus_tree_iter_load(struct bplus_tree_iter *iter)
+{
+    while ((iter->leaf != NULL) && (iter->pos >= iter->leaf->num))
+    {
+        iter->leaf = iter->leaf->next;
+        iter->pos = 0;
+    }
+
+    if (iter->leaf == NULL)
+    {
+        iter->key = NULL;
+        iter->value = NULL;
+        return -1;
+    }
+
+    iter->key = bplus_tree_key(iter->bptree, iter->leaf, iter->pos);
+    iter->value = iter->leaf->ptrs[iter->pos];
+
+    return 0;
+}
+
+/**
+ * 定位到最小的key.
+ *
+ * @param bptree: B+树
+ * @param iter: 遍历位置,iter->key/iter->value为当前数据
+ *
+ * @return 0:成功
+ *        -1:树为空 或 参数为空
+ */
+int bplus_tree_first(struct bplus_tree *bptree, struct bplus_tree_iter *iter)
+{
+    if (bptree == NULL || iter == NULL)
+        return -1;
+
+    iter->bptree = bptree;
+    iter->leaf = bplus_tree_leftmost(bptree->root);
+    iter->pos = 0;
+
+    return bplus_tree_iter_load(iter);
+}
+
+/**
+ * 定位到第一个不小于key的位置.
+ *
+ * @param bptree: B+树
+ * @param key: 查找的key
+ * @param iter: 遍历位置,iter->key/iter->value为当前数据
+ *
+ * @return 0:成功
+ *        -1:所有key都小于key 或 参数为空
+ */
+int bplus_tree_seek(struct bplus_tree *bptree, const void *key, struct bplus_tree_iter *iter)
+{
+    if (bptree == NULL || key == NULL || iter == NULL)
+        return -1;
+
+    iter->bptree = bptree;
+    iter->leaf = bplus_tree_find_leaf(bptree, key, NULL, NULL);
+    iter->pos = bplus_tree_lower(bptree, iter->leaf, key);
+
+    return bplus_tree_iter_load(iter);
+}
+
+/**
+ * 移到下一个key.
+ *
+ * @return 0:成功
+ *        -1:遍历结束
+ */
+int bplus_tree_next(struct bplus_tree_iter *iter)
+{
+    if (iter == NULL || iter->leaf == NULL)
+        return -1;
+
+    iter->pos++;
+
+    return bplus_tree_iter_load(iter);
+}
+
+/**
+ * 范围遍历,按key从小到大对 min <= key < max 的数据调用fun.
+ * 找到min所在的叶子节点后沿叶子链表顺序访问各叶子中连续存放的key和value.
+ *
+ * @param bptree: B+树
+ * @param min: 范围下限(包含),NULL表示从最小key开始
+ * @param max: 范围上限(不包含),NULL表示到最大key
+ * @param fun: 处理函数,返回非0时停止遍历; NULL时只计数
+ * @param param: 传给fun的参数
+ *
+ * @return -1:B+树不存在
+ *        >=0:访问的key个数
+ */
+int bplus_tree_range(struct bplus_tree *bptree, const void *min, const void *max, bptree_visit_fun fun, void *param)
+{
+    struct bplus_tree_node *leaf = NULL;
+    void *key = NULL;
+    int pos = 0, n = 0;
+
+    if (bptree == NULL)
+        return -1;
+
+    if (min != NULL)
+    {
+        leaf = bplus_tree_find_leaf(bptree, min, NULL, NULL);
+        pos = bplus_tree_lower(bptree, leaf, min);
+    }
+    else
+    {
+        leaf = bplus_tree_leftmost(bptree->root);
+    }
+
+    for (; leaf != NULL; leaf = leaf->next, pos = 0)
+    {
+        for (; pos < leaf->num; pos++)
+        {
+            key = bplus_tree_key(bptree, leaf, pos);
+            if ((max != NULL) && (bptree->keycmp(bptree, max, key) <= 0))
+                return n;
+
+            n++;
+            if ((fun != NULL) && (fun(bptree, key, leaf->ptrs[pos], param) != 0))
+                return n;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * 释放子树的所有节点,树高为O(log n),递归深度有限.
+ */
+static void bplus_tree_node_free(struct bplus_tree *bptree, struct bplus_tree_node *node)
+{
+    struct bplus_tree_entry entry;
+    int i = 0;
+
+    if (node->leaf)
+    {
+        for (i=0; (i<node->num) && (bptree->valuefree != NULL); i++)
+        {
+            entry.key = bplus_tree_key(bptree, node, i);
+            entry.value = node->ptrs[i];
+            bptree->valuefree(&entry);
+        }
+    }
+    else
+    {
+        for (i=0; i<=node->num; i++)
+        {
+            bplus_tree_node_free(bptree, node->ptrs[i]);
+        }
+    }
+
+    BPLUS_TREE_FREE(node);
+}
+
+/**
+ * 销毁一颗B+树
+ *
+ * @param bptree: B+树
+ */
+void bplus_tree_destroy(struct bplus_tree **bptree)
+{
+    if (bptree == NULL || *bptree == NULL)
+        return;
+
+    bplus_tree_node_free(*bptree, (*bptree)->root);
+    BPLUS_TREE_FREE(*bptree);
+    *bptree = NULL;
+}
+
+/*******************************************************************************************
+ *                                          使用示例
+ *******************************************************************************************/
+struct bplus_tree *bplus_tree_test = NULL;
+int bplus_tree_read[10];
+
+static int bplus_tree_sample_visit(struct bplus_tree *bptree, void *key, void *value, void *param)
+{
+    int *n = param;
+
+    bplus_tree_read[(*n)++] = *(int *)key;
+
+    return (*n >= 10);
+}
+
+/*int key按数值比较*/
+static int bplus_tree_sample_keycmp(struct bplus_tree *bptree, const void *key_cmp, const void *key_becmp)
+{
+    int a = *(const int *)key_cmp, b = *(const int *)key_becmp;
+
+    return (a > b) - (a < b);
+}
+
+void bplus_tree_sample(void)
+{
+    struct bplus_tree_iter iter;
+    int i = 0, n = 0, key = 0, min = 100, max = 200;
+    void *value = NULL;
+
+    /*int key复制到节点内*/
+    bplus_tree_test = bplus_tree_creat_key(sizeof(int), bplus_tree_sample_keycmp, NULL);
+
+    for (i=0; i<1000; i++)
+    {
+        key = i * 10;
+        bplus_tree_insert(bplus_tree_test, &key, (void *)(long)(i + 1));
+    }
+
+    key = 500;
+    bplus_tree_search(bplus_tree_test, &key, &value);
+    bplus_tree_delete(bplus_tree_test, &key);
+
+    /*100 <= key < 200*/
+    bplus_tree_range(bplus_tree_test, &min, &max, bplus_tree_sample_visit, &n);
+
+    /*从key 495开始顺序遍历*/
+    key = 495;
+    for (i = bplus_tree_seek(bplus_tree_test, &key, &iter), n = 0; (i == 0) && (n < 10); i = bplus_tree_next(&iter), n++)
+    {
+        bplus_tree_read[n] = *(int *)iter.key;
+    }
+
+    bplus_tree_destroy(&bplus_tree_test);
+}
+
+/*******************************************************************************************
+ *                                   与AVL树性能对比
+ *******************************************************************************************/
+#define BPLUS_TREE_BENCH_NUM  100000
+
+/*
+ * 乱序插入BPLUS_TREE_BENCH_NUM个int key后逐个查找、再全部顺序遍历的耗时(tick)
+ * [0]:avl_tree [1]:bplus_tree, [x][0]:插入 [x][1]:查找 [x][2]:遍历
+ */
+TickType_t bplus_tree_bench_ticks[2][3];
+
+static int bplus_tree_bench_keycmp(struct bplus_tree *bptree, const void *key_cmp, const void *key_becmp)
+{
+    int a = *(const int *)key_cmp, b = *(const int *)key_becmp;
+
+    return (a > b) - (a < b);
+}
+
+static int bplus_tree_bench_avlcmp(struct avl_tree *avltree, const void *key_cmp, const void *key_becmp)
+{
+    int a = *(const int *)key_cmp, b = *(const int *)key_becmp;
+
+    return (a > b) - (a < b);
+}
+
+/*AVL树中序遍历,沿父节点回溯,与bplus_tree_bench_visit一样累加key*/
+static long bplus_tree_bench_avlwalk(struct avl_tree *avltree)
+{
+    struct avl_tree_node *node = avltree->root;
+    long sum = 0;
+
+    while ((node != NULL) && (node->left_child != NULL))
+    {
+        node = node->left_child;
+    }
+    while (node != NULL)
+    {
+        sum += *(int *)node->key;
+        if (node->right_child != NULL)
+        {
+            node = node->right_child;
+            while (node->left_child != NULL)
+            {
+                node = node->left_child;
+            }
+        }
+        else
+        {
+            while ((node->parent != NULL) && (node->parent->right_child == node))
+            {
+                node = node->parent;
+            }
+            node = node->parent;
+        }
+    }
+
+    return sum;
+}
+
+static int bplus_tree_bench_visit(struct bplus_tree *bptree, void *key, void *value, void *param)
+{
+    *(long *)param += *(int *)key;
+
+    return 0;
+}
+
+void bplus_tree_bench(void)
+{
+    struct avl_tree *avltree = NULL;
+    struct bplus_tree *bptree = NULL;
+    struct avl_tree_node *node = NULL;
+    TickType_t start = 0;
+    int *keys = NULL;
+    unsigned int seed = 1;
+    long sum = 0;
+    int i = 0, j = 0, t = 0;
+
+    keys = BPLUS_TREE_MALLOC(BPLUS_TREE_BENCH_NUM * sizeof(int));
+    if (keys == NULL)
+        return;
+    /*0~NUM-1打乱顺序*/
+    for (i=0; i<BPLUS_TREE_BENCH_NUM; i++)
+    {
+        keys[i] = i;
+    }
+    for (i=BPLUS_TREE_BENCH_NUM-1; i>0; i--)
+    {
+        seed = seed * 1103515245 + 12345;
+        j = (int)((seed >> 8) % (unsigned int)(i + 1));
+        t = keys[i];
+        keys[i] = keys[j];
+        keys[j] = t;
+    }
+
+    avltree = avl_tree_creat(bplus_tree_bench_avlcmp, NULL);
+    if (avltree != NULL)
+    {
+        start = xTaskGetTickCount();
+        for (i=0; i<BPLUS_TREE_BENCH_NUM; i++)
+        {
+            avl_tree_insert(avltree, &keys[i], &keys[i]);
+        }
+        bplus_tree_bench_ticks[0][0] = xTaskGetTickCount() - start;
+
+        start = xTaskGetTickCount();
+        for (i=0; i<BPLUS_TREE_BENCH_NUM; i++)
+        {
+            node = avltree->root;
+            while ((node != NULL) && (node->key != &keys[i]))
+            {
+                node = (avltree->keycmp(avltree, &keys[i], node->key) < 0) ? node->left_child : node->right_child;
+            }
+        }
+        bplus_tree_bench_ticks[0][1] = xTaskGetTickCount() - start;
+
+        start = xTaskGetTickCount();
+        sum = bplus_tree_bench_avlwalk(avltree);
+        bplus_tree_bench_ticks[0][2] = xTaskGetTickCount() - start;
+        avl_tree_destroy(&avltree);
+    }
+
+    bptree = bplus_tree_creat_key(sizeof(int), bplus_tree_bench_keycmp, NULL);
+    if (bptree != NULL)
+    {
+        start = xTaskGetTickCount();
+        for (i=0; i<BPLUS_TREE_BENCH_NUM; i++)
+        {
+            bplus_tree_insert(bptree, &keys[i], &keys[i]);
+        }
+        bplus_tree_bench_ticks[1][0] = xTaskGetTickCount() - start;
+
+        start = xTaskGetTickCount();
+        for (i=0; i<BPLUS_TREE_BENCH_NUM; i++)
+        {
+            bplus_tree_search(bptree, &keys[i], NULL);
+        }
+        bplus_tree_bench_ticks[1][1] = xTaskGetTickCount() - start;
+
+        start = xTaskGetTickCount();
+        sum = 0;
+        bplus_tree_range(bptree, NULL, NULL, bplus_tree_bench_visit, &sum);
+        bplus_tree_bench_ticks[1][2] = xTaskGetTickCount() - start;
+        bplus_tree_destroy(&bptree);
+    }
+
+    BPLUS_TREE_FREE(keys);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ */
+
+#ifndef __ALGO_BPLUS_TREE_H__
+#define __ALGO_BPLUS_TREE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BPLUS_TREE_MALLOC(size)    pvPortMalloc(size);
+#define BPLUS_TREE_FREE(p)         vPortFree(p);
+
+/*
+ * 每个节点最多的key个数.节点大小约为 (ORDER+1)*指针 + ORDER*key宽度,
+ * 32时int key的叶子节点约占6个cache line,树高约为log16(n)~log32(n)
+ */
+#define BPLUS_TREE_ORDER           32
+#define BPLUS_TREE_MIN_KEYS        ((BPLUS_TREE_ORDER - 1) / 2) /*非根节点最少的key个数,少于时向兄弟节点借或合并*/
+#define BPLUS_TREE_MAX_HEIGHT      16 /*插入/删除时查找路径在栈上按该大小分配*/
+
+struct bplus_tree;
+
+/*
+ * 删除/修改节点数据时传给valuefree的key和value.
+ * B+树的key/value保存在节点数组中,没有bs_tree_node那样每个key一个的节点,所以valuefree
+ * 不能像bstree_value_free一样传节点,改为传这个结构,前两个成员与bs_tree_node的key、value对应.
+ * key总是树中保存的key:keysize>0时为节点内复制的key(只读,不能释放),keysize为0时为插入时传入的key指针.
+ */
+struct bplus_tree_entry
+{
+    void *key;
+    void *value;
+};
+
+/*
+ * key比较, key_cmp:传入的要比较的key, key_becmp:被比较的key
+ * 与bstree_keycmp相同,第一个参数为所在的树(可以从bptree->keysize得到key长度)
+ * 返回值 > 0 : key_cmp > key_becmp
+ * 返回值 = 0 : key_cmp = key_becmp
+ * 返回值 < 0 : key_cmp < key_becmp
+*/
+typedef int (*bptree_keycmp)(struct bplus_tree *bptree, const void *key_cmp, const void *key_becmp);
+/* 节点数据删除函数,如果插入的key/value为动态分配,则需要在该函数中释放 */
+typedef int (*bptree_value_free)(struct bplus_tree_entry *entry);
+/* 范围遍历时的处理函数,返回非0时停止遍历 */
+typedef int (*bptree_visit_fun)(struct bplus_tree *bptree, void *key, void *value, void *param);
+
+/*
+ * 节点和key数组在一次申请的连续空间中: | struct bplus_tree_node | keys[BPLUS_TREE_ORDER] |
+ * 内部节点: ptrs[0..num]为子节点,ptrs[i]子树中的key < keys[i] <= ptrs[i+1]子树中的key
+ * 叶子节点: ptrs[0..num-1]为keys对应的value,叶子节点按key顺序双向链接,范围遍历只访问叶子
+ */
+struct bplus_tree_node
+{
+    int leaf;                           /*1:叶子节点*/
+    int num;                            /*key个数*/
+    struct bplus_tree_node *prev;       /*叶子节点:前一个叶子*/
+    struct bplus_tree_node *next;       /*叶子节点:后一个叶子*/
+    void *ptrs[BPLUS_TREE_ORDER + 1];
+    char keys[];                        /*keysize>0:key数据连续存放; 0:key指针*/
+};
+
+/*
+ * B+树,每个节点存放多个key,一次查找只访问树高个节点,key不能重复.
+ * keysize>0时key复制到节点内连续存放,节点内二分查找不需要再访问key指针指向的内存
+ */
+struct bplus_tree
+{
+    int num;                         /*key个数*/
+    int height;                      /*树高,只有根叶子节点时为1*/
+    int keysize;                     /*>0:key为keysize字节的数据,复制到节点内; 0:只保存key指针*/
+    struct bplus_tree_node *root;    /*根节点,不为NULL*/
+    bptree_keycmp        keycmp;     /*key比较*/
+    bptree_value_free    valuefree;  /*节点数据删除*/
+};
+
+/*顺序遍历的位置,key/value为当前位置的数据*/
+struct bplus_tree_iter
+{
+    struct bplus_tree *bptree;
+    struct bplus_tree_node *leaf;
+    int pos;
+    void *key;
+    void *value;
+};
+
+#define BPTREE_IS_EMPTY(tree) (tree->num == 0)
+
+extern struct bplus_tree *bplus_tree_creat(bptree_keycmp keycmp, bptree_value_free valuefree);
+extern struct bplus_tree *bplus_tree_creat_default(bptree_value_free valuefree);
+extern struct bplus_tree *bplus_tree_creat_key(int keysize, bptree_keycmp keycmp, bptree_value_free valuefree);
+extern int    bplus_tree_insert(struct bplus_tree *bptree, void *key, void *value);
+extern int    bplus_tree_delete(struct bplus_tree *bptree, void *key);
+extern int    bplus_tree_modify(struct bplus_tree *bptree, void *key, void *value);
+extern int    bplus_tree_search(struct bplus_tree *bptree, void *key, void **value);
+extern void * bplus_tree_search_min(struct bplus_tree *bptree);
+extern void * bplus_tree_search_max(struct bplus_tree *bptree);
+extern void   bplus_tree_destroy(struct bplus_tree **bptree);
+
+/*有序遍历,遍历过程中不能插入/删除*/
+extern int bplus_tree_first(struct bplus_tree *bptree, struct bplus_tree_iter *iter);
+extern int bplus_tree_seek (struct bplus_tree *bptree, const void *key, struct bplus_tree_iter *iter);
+extern int bplus_tree_next (struct bplus_tree_iter *iter);
+extern int bplus_tree_range(struct bplus_tree *bptree, const void *min, const void *max, bptree_visit_fun fun, void *param);
+
+extern void bplus_tree_sample(void);
+extern void bplus_tree_bench(void);
+
+#endif
+
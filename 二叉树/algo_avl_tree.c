@@ -0,0 +1,700 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ */
+
+#include "algo_avl_tree.h"
+#include "algo_bs_tree.h"
+
+
+/**
+ * key比较, key_cmp:传入的要比较的key, key_becmp:被比较的key
+ *
+ * @return > 0 : key_cmp > key_becmp
+ * @return = 0 : key_cmp = key_becmp
+ * @return < 0 : key_cmp < key_becmp
+ *
+ */
+static int avltree_keycmp_default(struct avl_tree *avltree, const void *key_cmp, const void *key_becmp)
+{
+    return strcmp(key_cmp, key_becmp);
+}
+
+/**
+ * 动态创建一个AVL树.
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct avl_tree *avl_tree_creat(avltree_keycmp keycmp, avltree_value_free valuefree)
+{
+    struct avl_tree *avltree = NULL;
+
+    if (keycmp == NULL)
+        return NULL;
+
+    avltree = AVL_TREE_MALLOC(sizeof(*avltree));
+    if (avltree == NULL)
+        return NULL;
+
+    avltree->num       = 0;
+    avltree->keycmp    = keycmp;
+    avltree->valuefree = valuefree;
+    avltree->root      = NULL;
+
+    return avltree;
+}
+
+/**
+ * 使用默认 key比较函数 动态创建一个AVL树.
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct avl_tree *avl_tree_creat_default(avltree_value_free valuefree)
+{
+    return avl_tree_creat(avltree_keycmp_default, valuefree);
+}
+
+static int avl_tree_height(struct avl_tree_node *node)
+{
+    return (node != NULL) ? node->height : 0;
+}
+
+static void avl_tree_update_height(struct avl_tree_node *node)
+{
+    int lh = avl_tree_height(node->left_child);
+    int rh = avl_tree_height(node->right_child);
+
+    node->height = ((lh > rh) ? lh : rh) + 1;
+}
+
+/**
+ * 用new_node替换old_node在父节点(或根节点)中的位置.
+ */
+static void avl_tree_replace_child(struct avl_tree *avltree, struct avl_tree_node *old_node, struct avl_tree_node *new_node)
+{
+    struct avl_tree_node *parent = old_node->parent;
+
+    if (parent == NULL)
+    {
+        avltree->root = new_node;
+    }
+    else if (parent->left_child == old_node)
+    {
+        parent->left_child = new_node;
+    }
+    else
+    {
+        parent->right_child = new_node;
+    }
+
+    if (new_node != NULL)
+    {
+        new_node->parent = parent;
+    }
+}
+
+/**
+ * 左旋,node的右子节点成为子树的根.
+ *
+ *     node                right
+ *    /    \              /     \
+ *   a    right   ==>   node     c
+ *       /     \       /    \
+ *      b       c     a      b
+ *
+ * @return 旋转后子树的根
+ */
+static struct avl_tree_node *avl_tree_rotate_left(struct avl_tree *avltree, struct avl_tree_node *node)
+{
+    struct avl_tree_node *right = node->right_child;
+
+    node->right_child = right->left_child;
+    if (right->left_child != NULL)
+    {
+        right->left_child->parent = node;
+    }
+
+    avl_tree_replace_child(avltree, node, right);
+    right->left_child = node;
+    node->parent = right;
+
+    avl_tree_update_height(node);
+    avl_tree_update_height(right);
+
+    return right;
+}
+
+/**
+ * 右旋,node的左子节点成为子树的根.
+ *
+ * @return 旋转后子树的根
+ */
+static struct avl_tree_node *avl_tree_rotate_right(struct avl_tree *avltree, struct avl_tree_node *node)
+{
+    struct avl_tree_node *left = node->left_child;
+
+    node->left_child = left->right_child;
+    if (left->right_child != NULL)
+    {
+        left->right_child->parent = node;
+    }
+
+    avl_tree_replace_child(avltree, node, left);
+    left->right_child = node;
+    node->parent = left;
+
+    avl_tree_update_height(node);
+    avl_tree_update_height(left);
+
+    return left;
+}
+
+/**
+ * 从node开始沿父节点向上更新高度,左右子树高度差为2时旋转:
+ * 1、LL/RR:一次右旋/左旋
+ * 2、LR/RL:先对子节点左旋/右旋,再对node右旋/左旋
+ * 子树高度不再变化时上面的节点都不受影响,提前结束.
+ */
+static void avl_tree_rebalance(struct avl_tree *avltree, struct avl_tree_node *node)
+{
+    int lh = 0, rh = 0, height = 0;
+
+    while (node != NULL)
+    {
+        lh = avl_tree_height(node->left_child);
+        rh = avl_tree_height(node->right_child);
+        height = node->height;
+
+        if (lh - rh > 1)
+        {
+            if (avl_tree_height(node->left_child->left_child) < avl_tree_height(node->left_child->right_child))
+            {
+                avl_tree_rotate_left(avltree, node->left_child);
+            }
+            node = avl_tree_rotate_right(avltree, node);
+        }
+        else if (rh - lh > 1)
+        {
+            if (avl_tree_height(node->right_child->right_child) < avl_tree_height(node->right_child->left_child))
+            {
+                avl_tree_rotate_right(avltree, node->right_child);
+            }
+            node = avl_tree_rotate_left(avltree, node);
+        }
+        else
+        {
+            avl_tree_update_height(node);
+            if (node->height == height)
+                break;
+        }
+
+        node = node->parent;
+    }
+}
+
+/**
+ * 查找第一个(中序遍历最左边)key相同的节点.
+ * 相同key的节点在中序遍历中连续,但旋转后可能分布在左右子树中,所以找到后继续在左子树中查找.
+ *
+ * @return NULL:节点不存在
+ */
+static struct avl_tree_node *avl_tree_find(struct avl_tree *avltree, void *key)
+{
+    struct avl_tree_node *node = avltree->root;
+    struct avl_tree_node *find = NULL;
+    int res = 0;
+
+    while (node != NULL)
+    {
+        res = avltree->keycmp(avltree, key, node->key);
+        if (res > 0)
+        {
+            node = node->right_child;
+        }
+        else
+        {
+            if (res == 0)
+            {
+                find = node;
+            }
+            node = node->left_child;
+        }
+    }
+
+    return find;
+}
+
+/**
+ * 中序遍历的下一个节点.
+ */
+static struct avl_tree_node *avl_tree_next(struct avl_tree_node *node)
+{
+    if (node->right_child != NULL)
+    {
+        node = node->right_child;
+        while (node->left_child != NULL)
+        {
+            node = node->left_child;
+        }
+        return node;
+    }
+
+    while ((node->parent != NULL) && (node == node->parent->right_child))
+    {
+        node = node->parent;
+    }
+
+    return node->parent;
+}
+
+/**
+ * 向AVL树插入一个节点.支持相同key值的节点插入
+ *
+ * @param avltree: AVL树
+ * @param key: 关键值
+ * @param value: 节点数据
+ *
+ * @return 0:插入成功
+ *        -1:AVL树不存在 或 key为空 或 value为空
+ *        -2:节点空间申请失败
+ */
+int avl_tree_insert(struct avl_tree *avltree, void *key, void *value)
+{
+    struct avl_tree_node *new_node = NULL;
+    struct avl_tree_node *f_node = NULL;
+    struct avl_tree_node *node = NULL;
+    int res = 0;
+
+    if (avltree == NULL || key == NULL || value == NULL)
+        return -1;
+
+    new_node = (struct avl_tree_node*)AVL_TREE_MALLOC(sizeof(*new_node));
+    if (new_node == NULL)
+        return -2;
+
+    new_node->key = key;
+    new_node->value = value;
+    new_node->left_child = NULL;
+    new_node->right_child = NULL;
+    new_node->height = 1;
+
+    /*找到插入位置,相同key插入到右子树*/
+    node = avltree->root;
+    while (node != NULL)
+    {
+        f_node = node;
+        res = avltree->keycmp(avltree, key, node->key);
+        node = (res >= 0) ? node->right_child : node->left_child;
+    }
+
+    new_node->parent = f_node;
+    if (f_node == NULL)
+    {
+        avltree->root = new_node;
+    }
+    else if (res >= 0)
+    {
+        f_node->right_child = new_node;
+    }
+    else
+    {
+        f_node->left_child = new_node;
+    }
+    avltree->num ++;
+
+    avl_tree_rebalance(avltree, f_node);
+
+    return 0;
+}
+
+/**
+ * 从树中摘除一个节点并释放节点空间,不释放节点数据.
+ * 有两个子节点时,把右子树中最小节点的数据移到该节点上,转为摘除最小节点.
+ */
+static void avl_tree_remove(struct avl_tree *avltree, struct avl_tree_node *del_node)
+{
+    struct avl_tree_node *minnode = NULL;
+    struct avl_tree_node *child = NULL;
+    struct avl_tree_node *parent = NULL;
+
+    if ((del_node->left_child != NULL) && (del_node->right_child != NULL))
+    {
+        minnode = del_node->right_child;
+        while (minnode->left_child != NULL)
+        {
+            minnode = minnode->left_child;
+        }
+
+        del_node->key = minnode->key;
+        del_node->value = minnode->value;
+        del_node = minnode;
+    }
+
+    /*最多只有一个子节点,用子节点替换*/
+    child = (del_node->left_child != NULL) ? del_node->left_child : del_node->right_child;
+    parent = del_node->parent;
+    avl_tree_replace_child(avltree, del_node, child);
+    AVL_TREE_FREE(del_node);
+    avltree->num --;
+
+    avl_tree_rebalance(avltree, parent);
+}
+
+/**
+ * 删除节点,key相同的节点全部删除.
+ *
+ * @param avltree: AVL树
+ * @param key: 删除节点关键值
+ *
+ * @return 0:删除成功
+ *        -1:AVL树不存在 或 key为空
+ *        -2:节点不存在
+ */
+int avl_tree_delete(struct avl_tree *avltree, void *key)
+{
+    struct avl_tree_node *del_node = NULL;
+    int res = -2;
+
+    if (avltree == NULL || key == NULL)
+        return -1;
+
+    while ((del_node = avl_tree_find(avltree, key)) != NULL)
+    {
+        /*先删除要删除节点上的数据,数据空间为动态申请的需要在这里先释放*/
+        if (avltree->valuefree != NULL)
+        {
+            avltree->valuefree(del_node);
+        }
+        avl_tree_remove(avltree, del_node);
+        res = 0;
+    }
+
+    return res;
+}
+
+/**
+ * 修改一个节点.注意事项:
+ * 1、会先释放节点指向的就数据空间
+ * 2、修改的节点必须为新动态分配的空间
+ * 3、如果有多个key值相同的节点,只会修改中序遍历中的第一个
+ *
+ * @param avltree: AVL树
+ * @param key: 修改节点关键值
+ * @param value: 修改节点数据
+ *
+ * @return 0:修改成功
+ *        -1:AVL树不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ */
+int avl_tree_modify(struct avl_tree *avltree, void *key, void *value)
+{
+    struct avl_tree_node *mody_node = NULL;
+
+    if (avltree == NULL || key == NULL || value == NULL)
+        return -1;
+
+    mody_node = avl_tree_find(avltree, key);
+    if (mody_node == NULL)
+        return -2;
+
+    if (avltree->valuefree != NULL)
+    {
+        avltree->valuefree(mody_node);
+    }
+    mody_node->key = key;
+    mody_node->value = value;
+
+    return 0;
+}
+
+/**
+ * 根据key查找节点数据,key相同的节点数据按插入顺序放入双向链表中.
+ *
+ * @param avltree: AVL树
+ * @param key: 查找节点关键值
+ * @param dlist: 存放查找到的节点数据
+ *
+ * @return 0:查找成功
+ *        -1:AVL树不存在 或 key为空 或 树为空
+ *        -2:节点不存在
+ */
+int avl_tree_search(struct avl_tree *avltree, void *key, struct double_list *dlist)
+{
+    struct avl_tree_node *ser_node = NULL;
+
+    if (avltree == NULL || key == NULL || AVLTREE_IS_EMPTY(avltree))
+        return -1;
+
+    ser_node = avl_tree_find(avltree, key);
+    if (ser_node == NULL)
+        return -2;
+
+    /*相同key的节点在中序遍历中连续*/
+    while ((ser_node != NULL) && (avltree->keycmp(avltree, key, ser_node->key) == 0))
+    {
+        double_list_add_node_tail(dlist, ser_node->value);
+        ser_node = avl_tree_next(ser_node);
+    }
+
+    return 0;
+}
+
+/**
+ * 查找树中的最小节点数据.
+ *
+ * @param avltree: AVL树
+ *
+ * @return NULL:树为空
+ *        !NULL:最小节点数据
+ */
+void * avl_tree_search_min(struct avl_tree *avltree)
+{
+    struct avl_tree_node *ser_node = NULL;
+
+    if (avltree == NULL || AVLTREE_IS_EMPTY(avltree))
+        return NULL;
+
+    ser_node = avltree->root;
+    while (ser_node->left_child != NULL)
+    {
+        ser_node = ser_node->left_child;
+    }
+
+    return ser_node->value;
+}
+
+/**
+ * 查找树中的最大节点数据.
+ *
+ * @param avltree: AVL树
+ *
+ * @return NULL:树为空
+ *        !NULL:最大节点数据
+ */
+void * avl_tree_search_max(struct avl_tree *avltree)
+{
+    struct avl_tree_node *ser_node = NULL;
+
+    if (avltree == NULL || AVLTREE_IS_EMPTY(avltree))
+        return NULL;
+
+    ser_node = avltree->root;
+    while (ser_node->right_child != NULL)
+    {
+        ser_node = ser_node->right_child;
+    }
+
+    return ser_node->value;
+}
+
+/**
+ * 中序遍历,并将节点数据放入双向链表中.树高为O(log n),递归深度有限.
+ *
+ * @param avltree: AVL树
+ * @param node: 开始遍历的子树根节点
+ * @param dlist: 存放节点数据
+ *
+ * @return 链表中的节点个数
+ */
+int avl_tree_inorder(struct avl_tree *avltree, struct avl_tree_node *node, struct double_list *dlist)
+{
+    if (avltree == NULL || AVLTREE_IS_EMPTY(avltree) || node == NULL)
+        return 0;
+
+    avl_tree_inorder(avltree, node->left_child, dlist);
+    double_list_add_node_tail(dlist, node->value);
+    avl_tree_inorder(avltree, node->right_child, dlist);
+
+    return dlist->len;
+}
+
+/**
+ * 清空节点数据
+ *
+ * @param avltree: AVL树
+ * @param node: 要清空的子树根节点
+ */
+void avl_tree_node_empty(struct avl_tree **avltree, struct avl_tree_node **node)
+{
+    if (*avltree == NULL || AVLTREE_IS_EMPTY((*avltree)))
+        return;
+
+    if (*node == NULL)
+    {
+        return;
+    }
+
+    avl_tree_node_empty(avltree, &(*node)->left_child);
+    avl_tree_node_empty(avltree, &(*node)->right_child);
+    if ((*avltree)->valuefree != NULL)
+    {
+        (*avltree)->valuefree(*node);
+    }
+    (*avltree)->num--;
+    AVL_TREE_FREE(*node);
+    *node = NULL;
+}
+
+/**
+ * 销毁一颗AVL树
+ *
+ * @param avltree: AVL树
+ */
+void avl_tree_destroy(struct avl_tree **avltree)
+{
+    avl_tree_node_empty(avltree, &(*avltree)->root);
+    AVL_TREE_FREE(*avltree);
+    *avltree = NULL;
+}
+
+/*******************************************************************************************
+ *                                          使用示例
+ *******************************************************************************************/
+struct avl_tree *avl_tree_test = NULL;
+char avl_tree_read[10][10];
+
+void avl_tree_sample(void)
+{
+    static char keys[10][10], values[10][10];
+    struct double_list *dlist = NULL;
+    struct double_list_node *dlist_node = NULL;
+    int i = 0;
+
+    avl_tree_test = avl_tree_creat_default(NULL);
+    dlist = double_list_creat();
+
+    /*key递增插入,树仍然平衡*/
+    for (i=0; i<10; i++)
+    {
+        sprintf(keys[i], "AAA%d", i / 2);
+        sprintf(values[i], "%d", i);
+        avl_tree_insert(avl_tree_test, keys[i], values[i]);//支持多个节点插入
+    }
+
+    /*相同key值的数据按插入顺序放入双向链表中*/
+    avl_tree_search(avl_tree_test, "AAA2", dlist);
+    dlist_node = dlist->head;
+    for (i=0; (i<dlist->len) && (i<10); i++)
+    {
+        memcpy(avl_tree_read[i], dlist_node->value, 10);
+        dlist_node = dlist_node->next;
+    }
+    double_list_node_empty(dlist, 0);
+
+    /*删除 -- 中序遍历*/
+    avl_tree_delete(avl_tree_test, "AAA1");
+    avl_tree_inorder(avl_tree_test, avl_tree_test->root, dlist);
+    dlist_node = dlist->head;
+    for (i=0; (i<dlist->len) && (i<10); i++)
+    {
+        memcpy(avl_tree_read[i], dlist_node->value, 10);
+        dlist_node = dlist_node->next;
+    }
+    double_list_node_empty(dlist, 0);
+
+    double_list_destroy(dlist, 0);
+    avl_tree_destroy(&avl_tree_test);
+}
+
+/*******************************************************************************************
+ *                                   有序插入性能对比
+ *******************************************************************************************/
+#define AVL_TREE_BENCH_NUM  10000
+
+/*
+ * key递增插入AVL_TREE_BENCH_NUM个节点后逐个查找的耗时(tick)
+ * [0]:bs_tree [1]:avl_tree, [x][0]:插入 [x][1]:查找
+ */
+TickType_t avl_tree_bench_ticks[2][2];
+int avl_tree_bench_height;
+
+static int avl_tree_bench_keycmp(struct avl_tree *avltree, const void *key_cmp, const void *key_becmp)
+{
+    return *(const int *)key_cmp - *(const int *)key_becmp;
+}
+
+static int bs_tree_bench_keycmp(struct bs_tree *bstree, const void *key_cmp, const void *key_becmp)
+{
+    return *(const int *)key_cmp - *(const int *)key_becmp;
+}
+
+static int bs_tree_bench_valuefree(struct bs_tree_node *node)
+{
+    return 0;
+}
+
+void avl_tree_bench(void)
+{
+    struct avl_tree *avltree = NULL;
+    struct bs_tree *bstree = NULL;
+    struct double_list *dlist = NULL;
+    TickType_t start = 0;
+    int *keys = NULL;
+    int i = 0;
+
+    keys = AVL_TREE_MALLOC(AVL_TREE_BENCH_NUM * sizeof(int));
+    dlist = double_list_creat();
+    if (keys == NULL || dlist == NULL)
+        goto _exit;
+    for (i=0; i<AVL_TREE_BENCH_NUM; i++)
+    {
+        keys[i] = i;
+    }
+
+    /*bs_tree退化为链表*/
+    bstree = bs_tree_creat(bs_tree_bench_keycmp, bs_tree_bench_valuefree);
+    if (bstree != NULL)
+    {
+        start = xTaskGetTickCount();
+        for (i=0; i<AVL_TREE_BENCH_NUM; i++)
+        {
+            bs_tree_insert(bstree, &keys[i], &keys[i]);
+        }
+        avl_tree_bench_ticks[0][0] = xTaskGetTickCount() - start;
+
+        start = xTaskGetTickCount();
+        for (i=0; i<AVL_TREE_BENCH_NUM; i++)
+        {
+            bs_tree_search(bstree, &keys[i], dlist);
+            double_list_node_empty(dlist, 0);
+        }
+        avl_tree_bench_ticks[0][1] = xTaskGetTickCount() - start;
+        bs_tree_destroy(&bstree);
+    }
+
+    avltree = avl_tree_creat(avl_tree_bench_keycmp, NULL);
+    if (avltree != NULL)
+    {
+        start = xTaskGetTickCount();
+        for (i=0; i<AVL_TREE_BENCH_NUM; i++)
+        {
+            avl_tree_insert(avltree, &keys[i], &keys[i]);
+        }
+        avl_tree_bench_ticks[1][0] = xTaskGetTickCount() - start;
+        avl_tree_bench_height = avl_tree_height(avltree->root);
+
+        start = xTaskGetTickCount();
+        for (i=0; i<AVL_TREE_BENCH_NUM; i++)
+        {
+            avl_tree_search(avltree, &keys[i], dlist);
+            double_list_node_empty(dlist, 0);
+        }
+        avl_tree_bench_ticks[1][1] = xTaskGetTickCount() - start;
+        avl_tree_destroy(&avltree);
+    }
+
+_exit:
+    if (dlist != NULL)
+    {
+        double_list_destroy(dlist, 0);
+    }
+    if (keys != NULL)
+    {
+        AVL_TREE_FREE(keys);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ */
+
+#ifndef __ALGO_AVL_TREE_H__
+#define __ALGO_AVL_TREE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "algo_double_list.h"
+
+#define AVL_TREE_MALLOC(size)    pvPortMalloc(size);
+#define AVL_TREE_FREE(p)         vPortFree(p);
+
+struct avl_tree_node;
+struct avl_tree;
+
+/*
+ * 平衡二叉树key比较, key_cmp:传入的要比较的key, key_becmp:被比较的key
+ * 返回值 > 0 : key_cmp > key_becmp
+ * 返回值 = 0 : key_cmp = key_becmp
+ * 返回值 < 0 : key_cmp < key_becmp
+*/
+typedef int (*avltree_keycmp)(struct avl_tree *avltree, const void *key_cmp, const void *key_becmp);
+/* 平衡二叉树中的节点数据删除函数,如果插入节点为动态分配,则需要在该函数中释放节点空间 */
+typedef int (*avltree_value_free)(struct avl_tree_node *node);
+
+struct avl_tree_node
+{
+    void *key;
+    void *value;
+    struct avl_tree_node *left_child;  /*左子树*/
+    struct avl_tree_node *right_child; /*右子树*/
+    struct avl_tree_node *parent;      /*父节点,插入/删除后沿父节点向上调整平衡*/
+    int height;                        /*以该节点为根的子树高度,叶子节点为1*/
+};
+
+/*
+ * AVL树,接口与bs_tree相同:
+ * 1、任意节点左右子树的高度差不超过1,树高不超过1.44*log2(n),插入/删除/查找最坏情况下都是O(log n)
+ * 2、key递增(时间戳、序号)插入时bs_tree退化为链表,AVL树仍保持平衡
+ * 3、支持相同key值的节点插入,相同key的节点在中序遍历中连续
+ */
+struct avl_tree
+{
+    int num;                         /*树中节点个数的总和*/
+    struct avl_tree_node *root;      /*根节点*/
+    avltree_keycmp        keycmp;    /*key比较*/
+    avltree_value_free    valuefree; /*节点数据删除*/
+};
+
+#define AVLTREE_IS_EMPTY(tree) (tree->num == 0)
+
+extern struct avl_tree *avl_tree_creat(avltree_keycmp keycmp, avltree_value_free valuefree);
+extern struct avl_tree *avl_tree_creat_default(avltree_value_free valuefree);
+extern int    avl_tree_insert(struct avl_tree *avltree, void *key, void *value);
+extern int    avl_tree_delete(struct avl_tree *avltree, void *key);
+extern int    avl_tree_modify(struct avl_tree *avltree, void *key, void *value);
+extern int    avl_tree_search(struct avl_tree *avltree, void *key, struct double_list *dlist);
+extern void * avl_tree_search_min(struct avl_tree *avltree);
+extern void * avl_tree_search_max(struct avl_tree *avltree);
+extern void   avl_tree_node_empty(struct avl_tree **avltree, struct avl_tree_node **node);
+extern void   avl_tree_destroy   (struct avl_tree **avltree);
+
+/*中序遍历,并将节点数据放入双向链表中,链表在使用完释放空间的时候,不能将节点数据空间删除*/
+extern int avl_tree_inorder(struct avl_tree *avltree, struct avl_tree_node *node, struct double_list *dlist);
+
+extern void avl_tree_sample(void);
+extern void avl_tree_bench(void);
+
+#endif
+
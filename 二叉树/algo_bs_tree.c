@@ -4,6 +4,11 @@
  * Change Logs:
  * Date           Author       Notes
  * 2020-01-07     denghengli   the first version
+ * 2026-10-17     denghengli   parent pointers, allocation-free in-order iteration, non-recursive delete
+ * 2026-10-17     denghengli   duplicate-key value bucket mode, search stops at the first match
+ * 2026-10-17     denghengli   lower/upper bound, floor/ceiling, range and prefix queries
+ * 2026-10-17     denghengli   O(n) balanced build from sorted data and rebalance
+ * 2026-10-17     denghengli   per-tree node chunk arena, non-recursive node_empty/destroy
  */
 
 #include "algo_bs_tree.h"
@@ -44,6 +49,10 @@ struct bs_tree *bs_tree_creat(bstree_keycmp keycmp, bstree_value_free valuefree)
     bstree->keycmp    = keycmp;
     bstree->valuefree = valuefree;
     bstree->root      = NULL;
+    bstree->bucket    = 0;
+    bstree->bucketfree = NULL;
+    bstree->chunks    = NULL;
+    bstree->free_nodes = NULL;
     
     return bstree;
 }
@@ -60,6 +69,183 @@ struct bs_tree *bs_tree_creat_default(bstree_value_free valuefree)
 }
 
 
+/**
+ * 设置为桶模式,只能在树为空时设置.
+ * 桶模式下key相同的value按插入顺序放在同一个节点的数组中,查找相同key只需要一次查找,
+ * 树中不再有相同key的节点,num为不同key的个数.
+ * 相同key再次插入时只保存value,key使用第一次插入的key,传入的key不保存,仍由调用者管理.
+ * 一个节点上有多个value,按节点释放的valuefree无法区分各个value对应的内存,所以桶模式下不使用valuefree,
+ * 删除时对每个value调用一次bucketfree.
+ * 
+ * @param bstree: 二叉查找树,创建时valuefree需要为NULL
+ * @param bucketfree: 每个value的删除函数,不需要释放时为NULL
+ * 
+ * @return 0:设置成功
+ *        -1:二叉查找树不存在 或 树不为空 或 设置了valuefree
+ */
+int bs_tree_set_bucket(struct bs_tree *bstree, bstree_bucket_value_free bucketfree)
+{
+    if (bstree == NULL || !BSTREE_IS_EMPTY(bstree) || bstree->valuefree != NULL)
+        return -1;
+
+    bstree->bucket = 1;
+    bstree->bucketfree = bucketfree;
+
+    return 0;
+}
+
+/**
+ * 申请一个能放下num个节点的内存块.
+ */
+static struct bs_tree_chunk *bs_tree_chunk_creat(int num)
+{
+    struct bs_tree_chunk *chunk = NULL;
+
+    chunk = BS_TREE_MALLOC(sizeof(*chunk) + num * sizeof(struct bs_tree_node));
+    if (chunk == NULL)
+        return NULL;
+
+    chunk->next = NULL;
+    chunk->num = num;
+    chunk->used = 0;
+
+    return chunk;
+}
+
+/**
+ * 释放树的所有节点内存块,只释放内存,不处理节点数据.
+ */
+static void bs_tree_chunk_free(struct bs_tree *bstree)
+{
+    struct bs_tree_chunk *chunk = bstree->chunks;
+    struct bs_tree_chunk *next = NULL;
+
+    while (chunk != NULL)
+    {
+        next = chunk->next;
+        BS_TREE_FREE(chunk);
+        chunk = next;
+    }
+
+    bstree->chunks = NULL;
+    bstree->free_nodes = NULL;
+}
+
+/**
+ * 申请并初始化一个节点.优先使用空闲链表中的节点,其次从当前内存块中顺序分配,
+ * 当前内存块用完时再申请一个BS_TREE_CHUNK_NODES个节点的内存块.
+ */
+static struct bs_tree_node *bs_tree_node_creat(struct bs_tree *bstree, void *key, void *value, struct bs_tree_node *parent)
+{
+    struct bs_tree_node *new_node = NULL;
+    struct bs_tree_chunk *chunk = NULL;
+
+    if (bstree->free_nodes != NULL)
+    {
+        new_node = bstree->free_nodes;
+        bstree->free_nodes = new_node->right_child;
+    }
+    else
+    {
+        if ((bstree->chunks == NULL) || (bstree->chunks->used == bstree->chunks->num))
+        {
+            chunk = bs_tree_chunk_creat(BS_TREE_CHUNK_NODES);
+            if (chunk == NULL)
+                return NULL;
+            chunk->next = bstree->chunks;
+            bstree->chunks = chunk;
+        }
+        new_node = &bstree->chunks->nodes[bstree->chunks->used++];
+    }
+
+    new_node->key = key;
+    new_node->value = value;
+    new_node->left_child = NULL;
+    new_node->right_child = NULL;
+    new_node->parent = parent;
+    new_node->bucket = NULL;
+
+    return new_node;
+}
+
+/**
+ * 释放一个节点,放入空闲链表,内存块在销毁或重建时整块释放.
+ */
+static void bs_tree_node_release(struct bs_tree *bstree, struct bs_tree_node *node)
+{
+    node->key = NULL;
+    node->right_child = bstree->free_nodes;
+    bstree->free_nodes = node;
+}
+
+/**
+ * 把value加入节点的桶中,桶满时申请加倍大小的桶并复制原来的value.
+ * 
+ * @return 0:成功
+ *        -2:空间申请失败
+ */
+static int bs_tree_bucket_add(struct bs_tree_node *node, void *value)
+{
+    struct bs_tree_bucket *bucket = node->bucket;
+    struct bs_tree_bucket *new_bucket = NULL;
+    int size = 0;
+
+    if ((bucket == NULL) || (bucket->num == bucket->size))
+    {
+        size = (bucket != NULL) ? (bucket->size * 2) : BS_TREE_BUCKET_SIZE;
+        new_bucket = BS_TREE_MALLOC(sizeof(*new_bucket) + size * sizeof(void *));
+        if (new_bucket == NULL)
+            return -2;
+
+        new_bucket->size = size;
+        if (bucket != NULL)
+        {
+            new_bucket->num = bucket->num;
+            memcpy(new_bucket->values, bucket->values, bucket->num * sizeof(void *));
+            BS_TREE_FREE(bucket);
+        }
+        else
+        {
+            new_bucket->num = 1;
+            new_bucket->values[0] = node->value;
+        }
+        node->bucket = bucket = new_bucket;
+    }
+
+    bucket->values[bucket->num++] = value;
+
+    return 0;
+}
+
+/**
+ * 释放节点上的所有value,桶模式下对每个value调用一次bucketfree,否则对节点调用valuefree.
+ */
+static void bs_tree_node_free_values(struct bs_tree *bstree, struct bs_tree_node *node)
+{
+    void **values = NULL;
+    int i = 0, n = 0;
+
+    if (!bstree->bucket)
+    {
+        if (bstree->valuefree != NULL)
+        {
+            bstree->valuefree(node);
+        }
+        return;
+    }
+
+    n = bs_tree_node_values(node, &values);
+    for (i=0; (i<n) && (bstree->bucketfree != NULL); i++)
+    {
+        bstree->bucketfree(bstree, values[i]);
+    }
+    if (node->bucket != NULL)
+    {
+        BS_TREE_FREE(node->bucket);
+        node->bucket = NULL;
+    }
+}
+
 /**
  * 向一个二叉查找树插入一个节点.支持相同key值的节点插入
  * 
@@ -81,19 +267,12 @@ int bs_tree_insert(struct bs_tree *bstree, void *key, void *value)
     if (bstree == NULL || key == NULL || value == NULL)
         return -1;
 
-    /*申请二叉查找树节点空间*/
-    new_node = (struct bs_tree_node*)BS_TREE_MALLOC(sizeof(*new_node));
-    if (new_node == NULL)
-        return -2;
-    
-    new_node->key = key;
-    new_node->value = value;
-    new_node->left_child = NULL;
-    new_node->right_child = NULL;
-    
     /*数为空，插入到根节点*/
     if (BSTREE_IS_EMPTY(bstree))
     {
+        new_node = bs_tree_node_creat(bstree, key, value, NULL);
+        if (new_node == NULL)
+            return -2;
         bstree->root = new_node;
         bstree->num ++;
         return 0;
@@ -104,10 +283,17 @@ int bs_tree_insert(struct bs_tree *bstree, void *key, void *value)
         while (f_node != NULL)
         {
             res = bstree->keycmp(bstree, key, f_node->key);
-            if (res >= 0) /*去右子树中查找,支持相同key值的节点插入*/
+            if ((res == 0) && bstree->bucket) /*桶模式下放入相同key节点的桶中*/
+            {
+                return bs_tree_bucket_add(f_node, value);
+            }
+            else if (res >= 0) /*去右子树中查找,支持相同key值的节点插入*/
             {
                 if (f_node->right_child == NULL)
                 {
+                    new_node = bs_tree_node_creat(bstree, key, value, f_node);
+                    if (new_node == NULL)
+                        return -2;
                     f_node->right_child = new_node;
                     bstree->num ++;
                     return 0;
@@ -118,6 +304,9 @@ int bs_tree_insert(struct bs_tree *bstree, void *key, void *value)
             {
                 if (f_node->left_child == NULL)
                 {
+                    new_node = bs_tree_node_creat(bstree, key, value, f_node);
+                    if (new_node == NULL)
+                        return -2;
                     f_node->left_child = new_node;
                     bstree->num ++;
                     return 0;
@@ -131,6 +320,48 @@ int bs_tree_insert(struct bs_tree *bstree, void *key, void *value)
 }
 
 
+/**
+ * 查找第一个key相同的节点.
+ */
+static struct bs_tree_node *bs_tree_find(struct bs_tree *bstree, void *key)
+{
+    struct bs_tree_node *node = bstree->root;
+    int res = 0;
+
+    while ((node != NULL) && ((res = bstree->keycmp(bstree, key, node->key)) != 0))
+    {
+        node = (res > 0) ? node->right_child : node->left_child;
+    }
+
+    return node;
+}
+
+/**
+ * 用new_node替换old_node在父节点(或根节点)中的位置.
+ */
+static void bs_tree_replace_child(struct bs_tree *bstree, struct bs_tree_node *old_node, struct bs_tree_node *new_node)
+{
+    struct bs_tree_node *parent = old_node->parent;
+
+    if (parent == NULL)//删除的是头结点
+    {
+        bstree->root = new_node;
+    }
+    else if (parent->left_child == old_node)
+    {
+        parent->left_child = new_node;
+    }
+    else
+    {
+        parent->right_child = new_node;
+    }
+
+    if (new_node != NULL)
+    {
+        new_node->parent = parent;
+    }
+}
+
 /**
  * 删除一个节点.
  * 
@@ -144,312 +375,783 @@ int bs_tree_insert(struct bs_tree *bstree, void *key, void *value)
 int bs_tree_delete(struct bs_tree *bstree, void *key)
 {
     struct bs_tree_node *del_node = NULL;//要删除节点
-    struct bs_tree_node *f_delnode = NULL;//要删除节点的父节点
     struct bs_tree_node *minnode = NULL;//最小节点
-    struct bs_tree_node *f_minnode = NULL;//最小节点的父节点
-    struct bs_tree_node *temp = NULL;
-    int finsh_flg = 0, res = 0;
+    struct bs_tree_node *child = NULL;//填补删除节点位置的子节点
+    int res = -2;
 
     if (bstree == NULL || key == NULL)
         return -1;
     
-    /*查找要删除的节点*/
-    del_node = bstree->root;
-    while ((del_node != NULL) && ((res = bstree->keycmp(bstree, key, del_node->key)) != 0))
+    /*key相同的节点都在第一个相同节点的右子树中,每次从根节点查找并删除一个,直到不存在*/
+    while ((del_node = bs_tree_find(bstree, key)) != NULL)
     {
-        f_delnode = del_node;
+        /*先删除要删除节点上的数据,数据空间为动态申请的需要在这里先释放*/
+        bs_tree_node_free_values(bstree, del_node);
+
+        /*如果删除的节点有两个子节点，则需要找到该节点的右子树中最小的节点，把他替换到要删除的节点上，然后删除这个最小节点
+         *最小节点没有左子树,转为删除最多只有一个子节点的节点
+         */
+        if ((del_node->left_child != NULL) && (del_node->right_child != NULL))
+        {
+            minnode = del_node->right_child;
+            while (minnode->left_child != NULL)//查找最小节点
+            {
+                minnode = minnode->left_child;
+            }
+
+            del_node->key = minnode->key;
+            del_node->value = minnode->value;
+            del_node->bucket = minnode->bucket;
+            del_node = minnode;
+        }
+
+        /*要删除的节点最多只有一个子节点,用子节点替换删除节点(没有子节点时为NULL)*/
+        child = (del_node->left_child != NULL) ? del_node->left_child : del_node->right_child;
+        bs_tree_replace_child(bstree, del_node, child);
+
+        bs_tree_node_release(bstree, del_node);
+        bstree->num --;
+        res = 0;
+    }
+      
+    return res;
+}
+
+/**
+ * 修改一个节点.注意事项:
+ * 1、会先释放节点指向的就数据空间(这里如果是realloc更大的数据空间,容易造成指针泄露,且是不知道整个数据结构的大小的) 
+ * 2、修改的节点必须为新动态分配的空间
+ * 3、如果修改的节点有多个key值相同的节点,只会修改最新查找的一个
+ * 4、桶模式下节点中的所有value都被释放,替换为一个value
+ *
+ * @param bstree: 二叉查找树
+ * @param key: 修改节点关键值
+ * @param value: 修改节点数据
+ * 
+ * @return 0:修改成功
+ *        -1:二叉查找树不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ */
+int bs_tree_modify(struct bs_tree *bstree, void *key, void *value)
+{
+    struct bs_tree_node *mody_node = NULL;
+    int res = -2;
+    
+    if (bstree == NULL || key == NULL || value == NULL)
+        return -1;
+
+    /*查找要修改的节点*/
+    mody_node = bstree->root;
+    while (mody_node != NULL)
+    {
+        res = bstree->keycmp(bstree, key, mody_node->key);
         if (res > 0)
         {
-            del_node = del_node->right_child;
+            mody_node = mody_node->right_child;
+        }
+        else if (res < 0)
+        {
+            mody_node = mody_node->left_child;
         }
         else
         {
-            del_node = del_node->left_child;
+            bs_tree_node_free_values(bstree, mody_node);   
+            mody_node->key = key;
+            mody_node->value = value;
+            res = 0;
+            break;
         }
     }
 
-    /*要删除的节点不存在*/
-    if (del_node == NULL)
-        return -2;
+    return res;
+}
+
+/**
+ * 根据key查找节点数据.
+ * 
+ * @param bstree: 二叉查找树
+ * @param key: 查找节点关键值
+ * 
+ * @return 0:查找成功
+ *        -1:二叉查找树不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ */
+int bs_tree_search(struct bs_tree *bstree, void *key, struct double_list *dlist)
+{
+    struct bs_tree_node *ser_node = NULL;
+    void **values = NULL;
+    int res = 0, ret = -2, i = 0, n = 0;
+    
+    if (bstree == NULL || key == NULL || BSTREE_IS_EMPTY(bstree))
+        return -1;
 
-    do
-    {           
-        if (bstree->keycmp(bstree, key, del_node->key) == 0)
-        {
-            /*如果删除的节点有两个子节点，则需要找到该节点的右子树中最小的节点，把他替换到要删除的节点上，然后删除这个最小节点
-            *
-            *1、f_min就为del，min为叶子节点，删除过程为：先将min的数据替换到del，再将f_min的右节点指向min的右节点（NULL），最后删除min
-            *2、f_min就为del，min还有右子树（不会再有左子树），删除过程为：先将min的数据替换到del，再将f_min的右节点指向min的右节点（！NULL），最后删除min
-            *3、f_min不为del，min为叶子节点，删除过程为：先将min的数据替换到del，再将f_min的左节点指向min的右节点（NULL），最后删除min
-            *4、f_min不为del，min还有右子树（不会再有左子树），删除过程为：先将min的数据替换到del，再将f_min的左节点指向min的右节点（！NULL），最后删除min
-            */
-            if ((del_node->left_child != NULL) && (del_node->right_child != NULL))
+    /*查找要查找的节点*/
+    ser_node = bstree->root;
+    while (ser_node != NULL)
+    {
+        res = bstree->keycmp(bstree, key, ser_node->key);
+        if (res > 0)
+        {
+            ser_node = ser_node->right_child;
+        }
+        else if (res < 0)
+        {
+            ser_node = ser_node->left_child;
+        }
+        else
+        {
+            n = bs_tree_node_values(ser_node, &values);
+            for (i=0; i<n; i++)
             {
-                f_minnode = del_node;
-                minnode = del_node->right_child;
-                while (minnode->left_child != NULL)//查找最小节点
-                {
-                    f_minnode = minnode;
-                    minnode = minnode->left_child;
-                }
+                double_list_add_node_tail(dlist, values[i]);
+            }
+            ret = 0;
 
-                /*先删除要删除节点上的数据,数据空间为动态申请的需要在这里先释放*/
-                bstree->valuefree(del_node);
+            /*桶模式下没有其他相同key的节点*/
+            if (bstree->bucket)
+                break;
+            ser_node = ser_node->right_child;
+        }
+    }
 
-                del_node->key = minnode->key;
-                del_node->value = minnode->value;
-                if (f_minnode == del_node)
-                {
-                    f_minnode->right_child = minnode->right_child;
-                }
-                else
-                {
-                    f_minnode->left_child = minnode->right_child;
-                }
+    return ret;
+}
 
-                /*交换最小节点和删除节点,因为真正删除的是最小节点,
-                删除节点的父节点的子节点还是删除节点*/
-                temp = minnode;
-                minnode = del_node;
-                del_node = temp;
-            }
-            /*要删除的节点只有左子树*/
-            else if (del_node->left_child != NULL)
-            {
-                /*先删除要删除节点上的数据,数据空间为动态申请的需要在这里先释放*/
-                bstree->valuefree(del_node);
-                
-                minnode = del_node->left_child;
+/**
+ * 返回节点上的所有value,桶模式下为桶中的value数组,否则为节点的value.
+ * 
+ * @param node: 节点
+ * @param values: 返回连续存放的value数组,插入/删除/修改该key后失效
+ * 
+ * @return value个数
+ */
+int bs_tree_node_values(struct bs_tree_node *node, void ***values)
+{
+    if (node->bucket != NULL)
+    {
+        *values = node->bucket->values;
+        return node->bucket->num;
+    }
 
-                finsh_flg = 1;
-            }
-            /*要删除的节点只有右子树*/
-            else if (del_node->right_child != NULL)
-            {
-                /*先删除要删除节点上的数据,数据空间为动态申请的需要在这里先释放*/
-                bstree->valuefree(del_node);
+    *values = &node->value;
+    return 1;
+}
 
-                minnode = del_node->right_child;
-            }
-            /*要删除节点没有子节点*/
-            else
-            {
-                /*先删除要删除节点上的数据,数据空间为动态申请的需要在这里先释放*/
-                bstree->valuefree(del_node);
+/**
+ * 根据key查找节点数据,不申请内存.桶模式下一次查找即可返回key相同的所有value,
+ * 非桶模式下只返回第一个相同key节点的value.
+ * 
+ * @param bstree: 二叉查找树
+ * @param key: 查找节点关键值
+ * @param values: 返回连续存放的value数组,插入/删除/修改该key后失效
+ * 
+ * @return >0:value个数
+ *         -1:二叉查找树不存在 或 key为空 或 values为空
+ *         -2:节点不存在
+ */
+int bs_tree_search_values(struct bs_tree *bstree, void *key, void ***values)
+{
+    struct bs_tree_node *ser_node = NULL;
 
-                minnode->left_child = NULL;
-                minnode->right_child = NULL;
-                minnode = NULL;
-            }
+    if (bstree == NULL || key == NULL || values == NULL)
+        return -1;
 
-            if (del_node == bstree->root)//删除的是头结点
-            {
-                bstree->root = minnode;
-            }
-            else
-            {
-                if (del_node == f_delnode->left_child)//删除节点在删除节点父节点的左子树上
-                {
-                    f_delnode->left_child = minnode;
-                }
-                else if (del_node == f_delnode->right_child)//删除节点在删除节点父节点的右子树上
-                {
-                    f_delnode->right_child = minnode;
-                }
-            }
+    ser_node = bs_tree_find(bstree, key);
+    if (ser_node == NULL)
+        return -2;
+
+    return bs_tree_node_values(ser_node, values);
+}
+
+/**
+ * 查找二叉树中的最小节点数据.
+ * 
+ * @param bstree: 二叉查找树
+ * 
+ * @return 0:查找成功
+ *        -1:二叉查找树不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ */
+void * bs_tree_search_min(struct bs_tree *bstree)
+{
+    struct bs_tree_node *ser_node = NULL;
+    
+    if (bstree == NULL || BSTREE_IS_EMPTY(bstree))
+        return NULL;
+
+    /*查找要查找的节点*/
+    ser_node = bstree->root;
+    while ((ser_node != NULL) && (ser_node->left_child != NULL))
+    {
+        ser_node = ser_node->left_child;
+    }
+
+    if (ser_node != NULL)
+    {
+        return ser_node->value;
+    }
+
+    return NULL;
+}
+
+/**
+ * 查找二叉树中的最大节点数据.
+ * 
+ * @param bstree: 二叉查找树
+ * 
+ * @return 0:查找成功
+ *        -1:二叉查找树不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ */
+void * bs_tree_search_max(struct bs_tree *bstree)
+{
+    struct bs_tree_node *ser_node = NULL;
+    
+    if (bstree == NULL || BSTREE_IS_EMPTY(bstree))
+        return NULL;
+
+    /*查找要查找的节点*/
+    ser_node = bstree->root;
+    while ((ser_node != NULL) && (ser_node->right_child != NULL))
+    {
+        ser_node = ser_node->right_child;
+    }
+
+    if (ser_node != NULL)
+    {
+        return ser_node->value;
+    }
+
+    return NULL;
+}
+
+/**
+ * 子树中key最小的节点.
+ */
+static struct bs_tree_node *bs_tree_leftmost(struct bs_tree_node *node)
+{
+    while (node->left_child != NULL)
+    {
+        node = node->left_child;
+    }
+
+    return node;
+}
+
+/**
+ * 子树中key最大的节点.
+ */
+static struct bs_tree_node *bs_tree_rightmost(struct bs_tree_node *node)
+{
+    while (node->right_child != NULL)
+    {
+        node = node->right_child;
+    }
+
+    return node;
+}
+
+/**
+ * 返回key最小的节点,和bs_tree_next配合按key从小到大遍历.
+ * 
+ * @param bstree: 二叉查找树
+ * 
+ * @return NULL:树为空
+ */
+struct bs_tree_node *bs_tree_first(struct bs_tree *bstree)
+{
+    if (bstree == NULL || bstree->root == NULL)
+        return NULL;
+
+    return bs_tree_leftmost(bstree->root);
+}
+
+/**
+ * 返回key最大的节点,和bs_tree_prev配合按key从大到小遍历.
+ * 
+ * @param bstree: 二叉查找树
+ * 
+ * @return NULL:树为空
+ */
+struct bs_tree_node *bs_tree_last(struct bs_tree *bstree)
+{
+    if (bstree == NULL || bstree->root == NULL)
+        return NULL;
+
+    return bs_tree_rightmost(bstree->root);
+}
+
+/**
+ * 中序遍历的下一个节点:有右子树时为右子树的最小节点,否则沿父节点向上,第一个从左子树上来的父节点.
+ * 
+ * @param node: 当前节点
+ * 
+ * @return NULL:node为最后一个节点
+ */
+struct bs_tree_node *bs_tree_next(struct bs_tree_node *node)
+{
+    if (node == NULL)
+        return NULL;
+
+    if (node->right_child != NULL)
+        return bs_tree_leftmost(node->right_child);
+
+    while ((node->parent != NULL) && (node == node->parent->right_child))
+    {
+        node = node->parent;
+    }
+
+    return node->parent;
+}
+
+/**
+ * 中序遍历的上一个节点.
+ * 
+ * @param node: 当前节点
+ * 
+ * @return NULL:node为第一个节点
+ */
+struct bs_tree_node *bs_tree_prev(struct bs_tree_node *node)
+{
+    if (node == NULL)
+        return NULL;
+
+    if (node->left_child != NULL)
+        return bs_tree_rightmost(node->left_child);
+
+    while ((node->parent != NULL) && (node == node->parent->left_child))
+    {
+        node = node->parent;
+    }
+
+    return node->parent;
+}
+
+/**
+ * 按key从小到大对每个节点调用fun,不递归也不申请内存.
+ * 
+ * @param bstree: 二叉查找树
+ * @param fun: 节点处理函数,返回非0时停止遍历
+ * @param param: 传给fun的参数
+ * 
+ * @return -1:二叉查找树不存在 或 fun为空
+ *        >=0:访问的节点个数
+ */
+int bs_tree_foreach(struct bs_tree *bstree, bstree_visit_fun fun, void *param)
+{
+    struct bs_tree_node *node = NULL;
+    int n = 0;
+
+    if (bstree == NULL || fun == NULL)
+        return -1;
+
+    for (node = bs_tree_first(bstree); node != NULL; node = bs_tree_next(node))
+    {
+        n++;
+        if (fun(bstree, node, param) != 0)
+            break;
+    }
+
+    return n;
+}
+
+/**
+ * 查找第一个key不小于key的节点(中序遍历顺序),和bs_tree_next配合从key开始顺序遍历.
+ * 
+ * @param bstree: 二叉查找树
+ * @param key: 查找的key
+ * 
+ * @return NULL:所有节点的key都小于key
+ */
+struct bs_tree_node *bs_tree_lower_bound(struct bs_tree *bstree, const void *key)
+{
+    struct bs_tree_node *node = NULL;
+    struct bs_tree_node *find = NULL;
+
+    if (bstree == NULL || key == NULL)
+        return NULL;
+
+    node = bstree->root;
+    while (node != NULL)
+    {
+        if (bstree->keycmp(bstree, key, node->key) <= 0)
+        {
+            find = node;/*满足条件,继续在左子树中找更小的*/
+            node = node->left_child;
+        }
+        else
+        {
+            node = node->right_child;
+        }
+    }
+
+    return find;
+}
+
+/**
+ * 查找第一个key大于key的节点.
+ * 
+ * @param bstree: 二叉查找树
+ * @param key: 查找的key
+ * 
+ * @return NULL:所有节点的key都不大于key
+ */
+struct bs_tree_node *bs_tree_upper_bound(struct bs_tree *bstree, const void *key)
+{
+    struct bs_tree_node *node = NULL;
+    struct bs_tree_node *find = NULL;
 
-            BS_TREE_FREE(del_node);
-            del_node = minnode;/*将删除节点指向填补的节点,继续判断删除节点的右子树是否还有相同key值的节点*/
+    if (bstree == NULL || key == NULL)
+        return NULL;
 
-            bstree->num --;    
+    node = bstree->root;
+    while (node != NULL)
+    {
+        if (bstree->keycmp(bstree, key, node->key) < 0)
+        {
+            find = node;
+            node = node->left_child;
         }
         else
         {
-            del_node = del_node->right_child;/*右子树不为空但key不相同*/
+            node = node->right_child;
         }
-                
-	/*1、删除节点只有左子树时则直接退出,因为没有右子树就不会有相同的key节点
-	  2、删除节点右子树不为空 或 右子树节点为空但是key值相同 则继续查找相同key值的节点
-	*/
-    } while ( ((del_node->right_child != NULL) || ((del_node->right_child == NULL) && (bstree->keycmp(bstree, key, del_node->key) == 0))) && !finsh_flg);
-      
-    return 0;
+    }
+
+    return find;
 }
 
 /**
- * 修改一个节点.注意事项:
- * 1、会先释放节点指向的就数据空间(这里如果是realloc更大的数据空间,容易造成指针泄露,且是不知道整个数据结构的大小的) 
- * 2、修改的节点必须为新动态分配的空间
- * 3、如果修改的节点有多个key值相同的节点,只会修改最新查找的一个
- *
+ * 查找key不大于key的最大节点,有多个相同key时返回中序遍历中的最后一个.
+ * 
  * @param bstree: 二叉查找树
- * @param key: 修改节点关键值
- * @param value: 修改节点数据
+ * @param key: 查找的key
  * 
- * @return 0:修改成功
- *        -1:二叉查找树不存在 或 key为空 或value为空
- *        -2:节点不存在
+ * @return NULL:所有节点的key都大于key
  */
-int bs_tree_modify(struct bs_tree *bstree, void *key, void *value)
+struct bs_tree_node *bs_tree_floor(struct bs_tree *bstree, const void *key)
 {
-    struct bs_tree_node *mody_node = NULL;
-    int res = -2;
-    
-    if (bstree == NULL || key == NULL || value == NULL)
-        return -1;
+    struct bs_tree_node *node = NULL;
+    struct bs_tree_node *find = NULL;
 
-    /*查找要修改的节点*/
-    mody_node = bstree->root;
-    while (mody_node != NULL)
+    if (bstree == NULL || key == NULL)
+        return NULL;
+
+    node = bstree->root;
+    while (node != NULL)
     {
-        res = bstree->keycmp(bstree, key, mody_node->key);
-        if (res > 0)
-        {
-            mody_node = mody_node->right_child;
-        }
-        else if (res < 0)
+        if (bstree->keycmp(bstree, key, node->key) >= 0)
         {
-            mody_node = mody_node->left_child;
+            find = node;/*满足条件,继续在右子树中找更大的*/
+            node = node->right_child;
         }
         else
         {
-            bstree->valuefree(mody_node);   
-            mody_node->key = key;
-            mody_node->value = value;
-            res = 0;
-            break;
+            node = node->left_child;
         }
     }
 
-    return res;
+    return find;
 }
 
 /**
- * 根据key查找节点数据.
+ * 查找key不小于key的最小节点,与bs_tree_lower_bound相同.
  * 
  * @param bstree: 二叉查找树
- * @param key: 查找节点关键值
+ * @param key: 查找的key
  * 
- * @return 0:查找成功
- *        -1:二叉查找树不存在 或 key为空 或value为空
- *        -2:节点不存在
+ * @return NULL:所有节点的key都小于key
  */
-int bs_tree_search(struct bs_tree *bstree, void *key, struct double_list *dlist)
+struct bs_tree_node *bs_tree_ceiling(struct bs_tree *bstree, const void *key)
 {
-    struct bs_tree_node *ser_node = NULL;
-    int res = -2;
-    
-    if (bstree == NULL || key == NULL || BSTREE_IS_EMPTY(bstree))
+    return bs_tree_lower_bound(bstree, key);
+}
+
+/**
+ * 范围遍历,按key从小到大对 min <= key < max 的节点调用fun.
+ * 先用O(log n)找到第一个不小于min的节点,再沿中序遍历访问到max为止,只访问范围内的节点.
+ * 
+ * @param bstree: 二叉查找树
+ * @param min: 范围下限(包含),NULL表示从最小节点开始
+ * @param max: 范围上限(不包含),NULL表示到最大节点
+ * @param fun: 节点处理函数,返回非0时停止遍历; NULL时只计数
+ * @param param: 传给fun的参数
+ * 
+ * @return -1:二叉查找树不存在
+ *        >=0:访问的节点个数
+ */
+int bs_tree_range(struct bs_tree *bstree, const void *min, const void *max, bstree_visit_fun fun, void *param)
+{
+    struct bs_tree_node *node = NULL;
+    int n = 0;
+
+    if (bstree == NULL)
         return -1;
 
-    /*查找要查找的节点*/
-    ser_node = bstree->root;
-    while (ser_node != NULL)
+    node = (min != NULL) ? bs_tree_lower_bound(bstree, min) : bs_tree_first(bstree);
+    for (; node != NULL; node = bs_tree_next(node))
     {
-        res = bstree->keycmp(bstree, key, ser_node->key);
-        if (res > 0)
-        {
-            ser_node = ser_node->right_child;
-        }
-        else if (res < 0)
+        if ((max != NULL) && (bstree->keycmp(bstree, max, node->key) <= 0))
+            break;
+
+        n++;
+        if ((fun != NULL) && (fun(bstree, node, param) != 0))
+            break;
+    }
+
+    return n;
+}
+
+/**
+ * 前缀查找,按key从小到大对以prefix开头的节点调用fun.
+ * 只能用于key为字符串且按strcmp顺序比较的树(如bs_tree_creat_default创建的树),
+ * 以prefix开头的key在中序遍历中连续,从第一个不小于prefix的节点开始访问.
+ * 
+ * @param bstree: 二叉查找树
+ * @param prefix: 前缀字符串,""匹配所有节点
+ * @param fun: 节点处理函数,返回非0时停止遍历; NULL时只计数
+ * @param param: 传给fun的参数
+ * 
+ * @return -1:二叉查找树不存在 或 prefix为空
+ *        >=0:访问的节点个数
+ */
+int bs_tree_prefix(struct bs_tree *bstree, const char *prefix, bstree_visit_fun fun, void *param)
+{
+    struct bs_tree_node *node = NULL;
+    int len = 0, n = 0;
+
+    if (bstree == NULL || prefix == NULL)
+        return -1;
+
+    len = strlen(prefix);
+    for (node = bs_tree_lower_bound(bstree, prefix); node != NULL; node = bs_tree_next(node))
+    {
+        if (strncmp(node->key, prefix, len) != 0)
+            break;
+
+        n++;
+        if ((fun != NULL) && (fun(bstree, node, param) != 0))
+            break;
+    }
+
+    return n;
+}
+
+/**
+ * 把有序存放的nodes[lo, hi)连接为平衡树,返回子树根节点.
+ * 连接前每个节点的parent指向与它key相同的第一个节点,子树根节点选中间节点所在相同key组的第一个节点,
+ * 保持key相同的节点都在第一个相同节点的右子树中.只对左子树递归,右子树循环处理,递归深度不超过log2(n).
+ */
+static struct bs_tree_node *bs_tree_build(struct bs_tree_node *nodes, int lo, int hi)
+{
+    struct bs_tree_node *root = NULL;
+    struct bs_tree_node *parent = NULL;
+    struct bs_tree_node *node = NULL;
+    struct bs_tree_node **link = &root;
+    int i = 0;
+
+    while (lo < hi)
+    {
+        i = nodes[lo + (hi - lo) / 2].parent - nodes;
+        if (i < lo)
         {
-            ser_node = ser_node->left_child;
+            i = lo;
         }
-        else
+
+        node = &nodes[i];
+        node->left_child = bs_tree_build(nodes, lo, i);
+        if (node->left_child != NULL)
         {
-            double_list_add_node_tail(dlist, ser_node->value);
-            ser_node = ser_node->right_child;
-            res = 0;
+            node->left_child->parent = node;
         }
+        node->parent = parent;
+        *link = node;
+
+        parent = node;
+        link = &node->right_child;
+        lo = i + 1;
     }
+    *link = NULL;
 
-    return res;
+    return root;
 }
 
 /**
- * 查找二叉树中的最小节点数据.
+ * 由按key从小到大排好序的key/value数组建立平衡二叉树,树为空时才能建立.
+ * 所有节点在一次申请的内存块中按中序顺序存放,只需要O(n)次key比较,没有相同key时树高为log2(n)+1.
+ * 桶模式下相同key的value放入同一个节点的桶中.
  * 
  * @param bstree: 二叉查找树
+ * @param keys: 按keycmp从小到大(相同key相邻)的key数组
+ * @param values: 与keys对应的value数组
+ * @param num: key/value个数
  * 
- * @return 0:查找成功
- *        -1:二叉查找树不存在 或 key为空 或value为空
- *        -2:节点不存在
+ * @return 0:建立成功
+ *        -1:二叉查找树不存在 或 树不为空 或 参数为空
+ *        -2:节点空间申请失败
+ *        -3:keys不是从小到大排序的
  */
-void * bs_tree_search_min(struct bs_tree *bstree)
+int bs_tree_build_sorted(struct bs_tree *bstree, void **keys, void **values, int num)
 {
-    struct bs_tree_node *ser_node = NULL;
-    
-    if (bstree == NULL || BSTREE_IS_EMPTY(bstree))
-        return NULL;
+    struct bs_tree_chunk *chunk = NULL;
+    struct bs_tree_node *nodes = NULL;
+    int i = 0, n = 0, runs = 1;
 
-    /*查找要查找的节点*/
-    ser_node = bstree->root;
-    while ((ser_node != NULL) && (ser_node->left_child != NULL))
+    if (bstree == NULL || !BSTREE_IS_EMPTY(bstree) || keys == NULL || values == NULL || num <= 0)
+        return -1;
+
+    for (i=0; i<num; i++)
     {
-        ser_node = ser_node->left_child;
+        if (keys[i] == NULL || values[i] == NULL)
+            return -1;
     }
 
-    if (ser_node != NULL)
+    /*检查顺序并统计不同key的个数*/
+    for (i=1; i<num; i++)
     {
-        return ser_node->value;
+        n = bstree->keycmp(bstree, keys[i], keys[i-1]);
+        if (n < 0)
+            return -3;
+        if (n > 0)
+            runs++;
     }
 
-    return NULL;
+    chunk = bs_tree_chunk_creat(bstree->bucket ? runs : num);
+    if (chunk == NULL)
+        return -2;
+    nodes = chunk->nodes;
+
+    for (i=0, n=0; i<num; i++)
+    {
+        if ((n > 0) && (bstree->keycmp(bstree, keys[i], nodes[n-1].key) == 0))
+        {
+            /*桶模式下相同key的value放入前一个节点*/
+            if (bstree->bucket)
+            {
+                if (bs_tree_bucket_add(&nodes[n-1], values[i]) != 0)
+                    break;
+                continue;
+            }
+            nodes[n].parent = nodes[n-1].parent;
+        }
+        else
+        {
+            nodes[n].parent = &nodes[n];
+        }
+
+        nodes[n].key = keys[i];
+        nodes[n].value = values[i];
+        nodes[n].bucket = NULL;
+        n++;
+    }
+
+    if (i < num)
+    {
+        while (n-- > 0)
+        {
+            if (nodes[n].bucket != NULL)
+            {
+                BS_TREE_FREE(nodes[n].bucket);
+            }
+        }
+        BS_TREE_FREE(chunk);
+        return -2;
+    }
+
+    /*树为空时原来的内存块中都是空闲节点*/
+    bs_tree_chunk_free(bstree);
+    chunk->used = n;
+    bstree->chunks = chunk;
+    bstree->root = bs_tree_build(nodes, 0, n);
+    bstree->num = n;
+
+    return 0;
 }
 
 /**
- * 查找二叉树中的最大节点数据.
+ * 重建为平衡二叉树.按中序顺序把所有节点复制到一次申请的内存块中再连接,释放原来的内存块,
+ * key/value/桶不变,O(n).用于顺序插入等使树退化后恢复O(log n)的查找,同时回收删除节点占用的内存.
  * 
  * @param bstree: 二叉查找树
  * 
- * @return 0:查找成功
- *        -1:二叉查找树不存在 或 key为空 或value为空
- *        -2:节点不存在
+ * @return 0:重建成功
+ *        -1:二叉查找树不存在
+ *        -2:节点空间申请失败,树不变
  */
-void * bs_tree_search_max(struct bs_tree *bstree)
+int bs_tree_rebalance(struct bs_tree *bstree)
 {
-    struct bs_tree_node *ser_node = NULL;
-    
-    if (bstree == NULL || BSTREE_IS_EMPTY(bstree))
-        return NULL;
+    struct bs_tree_chunk *chunk = NULL;
+    struct bs_tree_node *nodes = NULL;
+    struct bs_tree_node *node = NULL;
+    int i = 0;
 
-    /*查找要查找的节点*/
-    ser_node = bstree->root;
-    while ((ser_node != NULL) && (ser_node->right_child != NULL))
+    if (bstree == NULL)
+        return -1;
+
+    if (bstree->num == 0)
     {
-        ser_node = ser_node->right_child;
+        bs_tree_chunk_free(bstree);
+        return 0;
     }
 
-    if (ser_node != NULL)
+    chunk = bs_tree_chunk_creat(bstree->num);
+    if (chunk == NULL)
+        return -2;
+    nodes = chunk->nodes;
+
+    for (node = bs_tree_first(bstree), i = 0; node != NULL; node = bs_tree_next(node), i++)
     {
-        return ser_node->value;
+        if ((i > 0) && (bstree->keycmp(bstree, node->key, nodes[i-1].key) == 0))
+        {
+            nodes[i].parent = nodes[i-1].parent;
+        }
+        else
+        {
+            nodes[i].parent = &nodes[i];
+        }
+        nodes[i].key = node->key;
+        nodes[i].value = node->value;
+        nodes[i].bucket = node->bucket;
     }
 
-    return NULL;
+    /*原来的节点都已复制,整块释放*/
+    bs_tree_chunk_free(bstree);
+    chunk->used = bstree->num;
+    bstree->chunks = chunk;
+    bstree->root = bs_tree_build(nodes, 0, bstree->num);
+
+    return 0;
 }
 
 /**
- * 中序遍历二叉树,并将节点数据放入双向链表中
+ * 中序遍历二叉树,并将节点数据放入双向链表中.
+ * 沿父节点遍历node子树,遍历到子树最大节点的下一个节点时结束,不递归.
  * 
  * @param bstree: 二叉查找树
+ * @param node: 遍历的子树根节点
+ * @param dlist: 存放节点数据
  * 
- * @return NULL:查找失败
- *        !NULL:查找成功.返回节点数据
+ * @return 链表中的节点个数
  */
 int bs_tree_inorder(struct bs_tree *bstree, struct bs_tree_node *node, struct double_list *dlist)
 {    
-    if (bstree == NULL || BSTREE_IS_EMPTY(bstree))
-        return NULL;
+    struct bs_tree_node *end = NULL;
+    void **values = NULL;
+    int i = 0, n = 0;
 
-    if (node == NULL)
+    if (bstree == NULL || BSTREE_IS_EMPTY(bstree) || node == NULL)
+        return 0;
+
+    end = bs_tree_next(bs_tree_rightmost(node));
+    for (node = bs_tree_leftmost(node); node != end; node = bs_tree_next(node))
     {
-        return NULL;
+        n = bs_tree_node_values(node, &values);
+        for (i=0; i<n; i++)
+        {
+            double_list_add_node_tail(dlist, values[i]);
+        }
     }
 
-    bs_tree_inorder(bstree, node->left_child, dlist);
-    double_list_add_node_tail(dlist, node->value);
-    bs_tree_inorder(bstree, node->right_child, dlist);
-
     return dlist->len;
 }
 
@@ -492,14 +1194,48 @@ int bs_tree_inorder(struct bs_tree *bstree, struct bs_tree_node *node, struct do
 //}
 
 /**
- * 清空二叉树节点数据
+ * 释放所有节点.不需要处理节点数据时直接释放内存块,O(内存块个数);
+ * 否则按内存块顺序对每个使用中的节点(key不为NULL)释放数据,不需要遍历树.
+ */
+static void bs_tree_clear(struct bs_tree *bstree)
+{
+    struct bs_tree_chunk *chunk = NULL;
+    int i = 0;
+
+    if ((bstree->valuefree != NULL) || bstree->bucket)
+    {
+        for (chunk = bstree->chunks; chunk != NULL; chunk = chunk->next)
+        {
+            for (i=0; i<chunk->used; i++)
+            {
+                if (chunk->nodes[i].key != NULL)
+                {
+                    bs_tree_node_free_values(bstree, &chunk->nodes[i]);
+                }
+            }
+        }
+    }
+
+    bs_tree_chunk_free(bstree);
+    bstree->root = NULL;
+    bstree->num = 0;
+}
+
+/**
+ * 清空node子树的节点数据.node为根节点时按内存块释放整棵树,
+ * 否则沿父节点后序遍历子树逐个释放,不递归,栈空间与树高无关.
  * 
  * @param bstree: 二叉查找树
+ * @param node: 清空的子树,清空后为NULL
  * 
  * @return 
  */
 void bs_tree_node_empty(struct bs_tree **bstree, struct bs_tree_node **node)
 {
+    struct bs_tree_node *cur = NULL;
+    struct bs_tree_node *parent = NULL;
+    struct bs_tree_node *top = NULL;
+
     if (*bstree == NULL || BSTREE_IS_EMPTY((*bstree)))
         return;
 
@@ -508,12 +1244,46 @@ void bs_tree_node_empty(struct bs_tree **bstree, struct bs_tree_node **node)
         return;
     }
 
-    bs_tree_node_empty(bstree, &(*node)->left_child);
-    bs_tree_node_empty(bstree, &(*node)->right_child);
-    (*bstree)->valuefree(*node);
-    (*bstree)->num--;
-    BS_TREE_FREE(*node);
-	*node = NULL;
+    if (*node == (*bstree)->root)
+    {
+        bs_tree_clear(*bstree);
+        return;
+    }
+
+    cur = *node;
+    top = cur->parent;
+    *node = NULL;
+    while (cur != NULL)
+    {
+        if (cur->left_child != NULL)
+        {
+            cur = cur->left_child;
+        }
+        else if (cur->right_child != NULL)
+        {
+            cur = cur->right_child;
+        }
+        else
+        {
+            /*叶子节点,释放后从父节点中断开,父节点可能成为叶子节点*/
+            parent = cur->parent;
+            if (parent != top)
+            {
+                if (parent->left_child == cur)
+                {
+                    parent->left_child = NULL;
+                }
+                else
+                {
+                    parent->right_child = NULL;
+                }
+            }
+            bs_tree_node_free_values(*bstree, cur);
+            bs_tree_node_release(*bstree, cur);
+            (*bstree)->num--;
+            cur = (parent != top) ? parent : NULL;
+        }
+    }
 }
 
 /**
@@ -525,7 +1295,10 @@ void bs_tree_node_empty(struct bs_tree **bstree, struct bs_tree_node **node)
  */
 void bs_tree_destroy(struct bs_tree **bstree)
 {
-    bs_tree_node_empty(bstree, &(*bstree)->root);
+    if (bstree == NULL || *bstree == NULL)
+        return;
+
+    bs_tree_clear(*bstree);
     BS_TREE_FREE(*bstree);
     *bstree = NULL;
 }
@@ -739,3 +1512,56 @@ void bs_tree_sample(void)
     bs_tree_destroy(&bs_tree_test);
 }
 
+
+/*******************************************************************************************
+ *                                   有序数据建立平衡树示例
+ *******************************************************************************************/
+static int bs_tree_build_keycmp(struct bs_tree *bstree, const void *key_cmp, const void *key_becmp)
+{
+    int a = *(const int *)key_cmp, b = *(const int *)key_becmp;
+
+    return (a > b) - (a < b);
+}
+
+int bs_tree_build_read[10];
+
+void bs_tree_build_sample(void)
+{
+    static int keys_data[100];
+    void *keys[100], *values[100];
+    struct bs_tree *bstree = NULL;
+    struct bs_tree_node *node = NULL;
+    int i = 0, key = 0;
+
+    bstree = bs_tree_creat(bs_tree_build_keycmp, NULL);
+    if (bstree == NULL)
+        return;
+
+    /*有序数据一次建立,树高为7*/
+    for (i=0; i<100; i++)
+    {
+        keys_data[i] = i * 2;
+        keys[i] = &keys_data[i];
+        values[i] = &keys_data[i];
+    }
+    bs_tree_build_sorted(bstree, keys, values, 100);
+
+    /*建立后仍可以插入/删除,顺序插入使右子树退化后重建*/
+    for (i=0; i<100; i++)
+    {
+        bs_tree_delete(bstree, keys[i]);
+    }
+    for (i=0; i<100; i++)
+    {
+        bs_tree_insert(bstree, keys[i], values[i]);
+    }
+    bs_tree_rebalance(bstree);
+
+    key = 51;
+    for (node = bs_tree_lower_bound(bstree, &key), i = 0; (node != NULL) && (i < 10); node = bs_tree_next(node), i++)
+    {
+        bs_tree_build_read[i] = *(int *)node->value;
+    }
+
+    bs_tree_destroy(&bstree);
+}
@@ -4,6 +4,11 @@
  * Change Logs:
  * Date           Author       Notes
  * 2020-01-07     denghengli   the first version
+ * 2026-10-17     denghengli   parent pointers, allocation-free in-order iteration, non-recursive delete
+ * 2026-10-17     denghengli   duplicate-key value bucket mode, search stops at the first match
+ * 2026-10-17     denghengli   lower/upper bound, floor/ceiling, range and prefix queries
+ * 2026-10-17     denghengli   O(n) balanced build from sorted data and rebalance
+ * 2026-10-17     denghengli   per-tree node chunk arena, non-recursive node_empty/destroy
  */
 
 #ifndef __ALGO_BS_TREE_H__
@@ -20,6 +25,9 @@
 #define BS_TREE_CALLOC(n,size)  calloc(n,size);
 #define BS_TREE_FREE(p)         vPortFree(p);
 
+#define BS_TREE_BUCKET_SIZE     4 /*桶模式下value数组的初始大小,不够时加倍*/
+#define BS_TREE_CHUNK_NODES     64 /*节点内存块中的节点个数*/
+
 struct bs_tree_node;
 struct bs_tree;
 
@@ -34,6 +42,22 @@ struct bs_tree;
 typedef int (*bstree_keycmp)(struct bs_tree *bstree, const void *key_cmp, const void *key_becmp);
 /* 二叉树中的节点数据删除函数,如果插入节点为动态分配,则需要在该函数中释放节点空间 */
 typedef int (*bstree_value_free)(struct bs_tree_node *node);
+/*
+ * 桶模式下的value删除函数,节点上的每个value调用一次.桶模式下树不释放key:
+ * 节点的key是第一次插入的key,在该节点的value全部删除前要保持有效;之后插入的相同key不保存,insert返回后由调用者处理.
+ * key和value在同一块动态申请的内存中时,在这里释放value所在的内存即可同时释放对应的key.
+ */
+typedef int (*bstree_bucket_value_free)(struct bs_tree *bstree, void *value);
+/* 中序遍历时的节点处理函数,返回非0时停止遍历 */
+typedef int (*bstree_visit_fun)(struct bs_tree *bstree, struct bs_tree_node *node, void *param);
+
+/*桶模式下key相同的所有value,按插入顺序连续存放*/
+struct bs_tree_bucket
+{
+    int num;         /*value个数*/
+    int size;        /*values数组大小*/
+    void *values[];
+};
 
 struct bs_tree_node
 {
@@ -41,6 +65,20 @@ struct bs_tree_node
     void *value;
     struct bs_tree_node *left_child;  /*左子树*/
     struct bs_tree_node *right_child; /*右子树*/
+    struct bs_tree_node *parent;      /*父节点,用于不递归、不申请内存的中序遍历*/
+    struct bs_tree_bucket *bucket;    /*桶模式下key相同的所有value(values[0]与value相同),只有一个value时为NULL*/
+};
+
+/*
+ * 节点内存块,插入时节点从内存块中顺序分配,删除的节点放入空闲链表再次使用,销毁时按内存块释放.
+ * bs_tree_build_sorted/bs_tree_rebalance一次申请一个放下所有节点的内存块.
+ */
+struct bs_tree_chunk
+{
+    struct bs_tree_chunk *next;
+    int num;                        /*内存块中的节点个数*/
+    int used;                       /*已分配过的节点个数,nodes[0, used)为使用中或空闲链表中的节点*/
+    struct bs_tree_node nodes[];
 };
 
 struct bs_tree
@@ -48,7 +86,11 @@ struct bs_tree
     int num;                        /*二叉树中节点个数的总和*/
     struct bs_tree_node *root;      /*二叉树的根节点*/
     bstree_keycmp        keycmp;    /*二叉树key比较*/
-    bstree_value_free    valuefree; /*二叉树节点数据删除*/
+    bstree_value_free    valuefree; /*二叉树节点数据删除,桶模式下不使用*/
+    int                  bucket;    /*1:桶模式,key相同的value放在同一个节点中,树高只与不同key的个数有关*/
+    bstree_bucket_value_free bucketfree; /*桶模式下每个value的删除函数*/
+    struct bs_tree_chunk *chunks;   /*节点内存块,第一个为当前分配节点的内存块*/
+    struct bs_tree_node *free_nodes;/*删除的节点,key为NULL,用right_child链接*/
 };
 
 #define BSTREE_IS_EMPTY(tree) (tree->num == 0)
@@ -64,10 +106,13 @@ struct bs_tree
 
 extern struct bs_tree *bs_tree_creat(bstree_keycmp keycmp, bstree_value_free valuefree);
 extern struct bs_tree *bs_tree_creat_default(bstree_value_free valuefree);
+extern int    bs_tree_set_bucket(struct bs_tree *bstree, bstree_bucket_value_free bucketfree);
 extern int    bs_tree_insert(struct bs_tree *bstree, void *key, void *value);
 extern int    bs_tree_delete(struct bs_tree *bstree, void *key);
 extern int    bs_tree_modify(struct bs_tree *bstree, void *key, void *value);
 extern int    bs_tree_search(struct bs_tree *bstree, void *key, struct double_list *dlist);
+extern int    bs_tree_search_values(struct bs_tree *bstree, void *key, void ***values);
+extern int    bs_tree_node_values(struct bs_tree_node *node, void ***values);
 extern void * bs_tree_search_min(struct bs_tree *bstree);
 extern void * bs_tree_search_max(struct bs_tree *bstree);
 extern void   bs_tree_node_empty(struct bs_tree **bstree, struct bs_tree_node **node);
@@ -76,7 +121,28 @@ extern void   bs_tree_destroy   (struct bs_tree **bstree);
 /*中序遍历二叉树，并将节点数据放入双向链表中，链表在使用完释放空间的时候，不能将节点数据空间删除*/
 extern int bs_tree_inorder(struct bs_tree *bstree, struct bs_tree_node *node, struct double_list *dlist);
 
+/*按key从小到大逐个访问节点,不申请内存,栈空间与树高无关.遍历过程中不能插入/删除节点*/
+extern struct bs_tree_node *bs_tree_first(struct bs_tree *bstree);
+extern struct bs_tree_node *bs_tree_last (struct bs_tree *bstree);
+extern struct bs_tree_node *bs_tree_next (struct bs_tree_node *node);
+extern struct bs_tree_node *bs_tree_prev (struct bs_tree_node *node);
+extern int bs_tree_foreach(struct bs_tree *bstree, bstree_visit_fun fun, void *param);
+
+/*有序查找,O(log n)*/
+extern struct bs_tree_node *bs_tree_lower_bound(struct bs_tree *bstree, const void *key);
+extern struct bs_tree_node *bs_tree_upper_bound(struct bs_tree *bstree, const void *key);
+extern struct bs_tree_node *bs_tree_floor  (struct bs_tree *bstree, const void *key);
+extern struct bs_tree_node *bs_tree_ceiling(struct bs_tree *bstree, const void *key);
+/*范围查找,O(log n + k)*/
+extern int bs_tree_range (struct bs_tree *bstree, const void *min, const void *max, bstree_visit_fun fun, void *param);
+extern int bs_tree_prefix(struct bs_tree *bstree, const char *prefix, bstree_visit_fun fun, void *param);
+
+/*由有序数据一次建立平衡树,O(n)*/
+extern int bs_tree_build_sorted(struct bs_tree *bstree, void **keys, void **values, int num);
+extern int bs_tree_rebalance   (struct bs_tree *bstree);
+
 extern void bs_tree_sample(void);
+extern void bs_tree_build_sample(void);
 
 #endif
 
@@ -0,0 +1,681 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   share hash_table callbacks, default hash and ops table
+ */
+
+#include "algo_hash_open.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * 对槽中的数据调用valuefree,回调参数为与hash_table相同的节点结构.
+ */
+static void hash_open_slot_free(struct hash_open *table, int pos)
+{
+    struct hash_table_node node;
+
+    if (table->conf.valuefree == NULL)
+        return;
+
+    node.key   = table->slots[pos].key;
+    node.value = table->slots[pos].value;
+    node.hash  = 0;
+    node.next  = NULL;
+    table->conf.valuefree(&node);
+}
+
+/**
+ * 在一组控制字节中查找等于ctrl的字节.
+ *
+ * @return 匹配的位图,第i位为1表示该组第i个控制字节匹配
+ */
+static unsigned int hash_open_group_match(const signed char *group, signed char ctrl)
+{
+#if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128((const __m128i *)group);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl), g));
+#else
+    unsigned int mask = 0;
+    int i = 0;
+
+    for (i = 0; i < HASH_OPEN_GROUP_WIDTH; i++)
+    {
+        if (group[i] == ctrl)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * 在一组控制字节中查找空槽或已删除的槽(控制字节小于-1).
+ *
+ * @return 匹配的位图
+ */
+static unsigned int hash_open_group_match_free(const signed char *group)
+{
+#if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128((const __m128i *)group);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), g));
+#else
+    unsigned int mask = 0;
+    int i = 0;
+
+    for (i = 0; i < HASH_OPEN_GROUP_WIDTH; i++)
+    {
+        if (group[i] < -1)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * 位图最低位的1所在的位置,mask不能为0.
+ */
+static int hash_open_ctz(unsigned int mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int i = 0;
+
+    while ((mask & 1u) == 0)
+    {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/**
+ * 查找key所在的槽.以组为单位做三角数探测(g, g+1, g+3, g+6...),组数为2的幂时可以遍历所有组;
+ * 遇到含有空槽的组说明key不可能在更后面的组中,停止查找.
+ *
+ * @return -1:key不存在
+ *        >=0:key所在槽的下标
+ */
+static int hash_open_find(struct hash_open *table, const void *key, unsigned int hash)
+{
+    unsigned int groups = table->capacity / HASH_OPEN_GROUP_WIDTH;
+    unsigned int g = (hash >> 7) & (groups - 1);
+    unsigned int step = 0, mask = 0;
+    signed char h2 = (signed char)(hash & 0x7F);
+    const signed char *group = NULL;
+    int i = 0;
+
+    while (step < groups)
+    {
+        group = table->ctrl + g * HASH_OPEN_GROUP_WIDTH;
+        mask = hash_open_group_match(group, h2);
+        while (mask != 0)
+        {
+            i = g * HASH_OPEN_GROUP_WIDTH + hash_open_ctz(mask);
+            if (table->conf.keycmp(&table->conf, key, table->slots[i].key) == 0)
+                return i;
+            mask &= mask - 1;
+        }
+
+        if (hash_open_group_match(group, HASH_OPEN_CTRL_EMPTY) != 0)
+            return -1;
+
+        step++;
+        g = (g + step) & (groups - 1);
+    }
+
+    return -1;
+}
+
+/**
+ * 按key的探测顺序查找第一个空槽或已删除的槽.调用前需保证growth_left > 0,即一定存在空槽.
+ *
+ * @return 槽的下标
+ */
+static int hash_open_find_free(struct hash_open *table, unsigned int hash)
+{
+    unsigned int groups = table->capacity / HASH_OPEN_GROUP_WIDTH;
+    unsigned int g = (hash >> 7) & (groups - 1);
+    unsigned int step = 0, mask = 0;
+
+    while (1)
+    {
+        mask = hash_open_group_match_free(table->ctrl + g * HASH_OPEN_GROUP_WIDTH);
+        if (mask != 0)
+            return g * HASH_OPEN_GROUP_WIDTH + hash_open_ctz(mask);
+
+        step++;
+        g = (g + step) & (groups - 1);
+    }
+}
+
+/**
+ * 重新申请capacity大小的槽数组,并将所有数据重新插入,同时清理掉已删除的槽.
+ *
+ * @return 0:成功
+ *        -1:空间申请失败
+ */
+static int hash_open_rehash(struct hash_open *table, int capacity)
+{
+    signed char *old_ctrl = table->ctrl;
+    struct hash_open_slot *old_slots = table->slots;
+    int old_capacity = table->capacity;
+    signed char *ctrl = NULL;
+    struct hash_open_slot *slots = NULL;
+    unsigned int hash = 0;
+    int i = 0, pos = 0;
+
+    ctrl = (signed char *)HASH_OPEN_MALLOC(capacity);
+    if (ctrl == NULL)
+        return -1;
+    slots = (struct hash_open_slot *)HASH_OPEN_MALLOC(capacity * sizeof(*slots));
+    if (slots == NULL)
+    {
+        HASH_OPEN_FREE(ctrl);
+        return -1;
+    }
+    memset(ctrl, HASH_OPEN_CTRL_EMPTY, capacity);
+
+    table->ctrl = ctrl;
+    table->slots = slots;
+    table->capacity = capacity;
+    table->growth_left = capacity - capacity / 8 - table->num;
+
+    if (old_ctrl == NULL)
+        return 0;
+
+    for (i = 0; i < old_capacity; i++)
+    {
+        if (old_ctrl[i] < 0)
+            continue;
+
+        hash = table->conf.hashfun(&table->conf, old_slots[i].key);
+        pos = hash_open_find_free(table, hash);
+        ctrl[pos] = (signed char)(hash & 0x7F);
+        slots[pos] = old_slots[i];
+    }
+
+    HASH_OPEN_FREE(old_ctrl);
+    HASH_OPEN_FREE(old_slots);
+
+    return 0;
+}
+
+/**
+ * 动态创建一个开放寻址哈希表.回调函数与hash_table_creat相同.
+ *
+ * @param size: 预计存放的数据个数,按最大负载7/8计算初始槽个数
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct hash_open *hash_open_creat(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree)
+{
+    struct hash_open *table = NULL;
+    int capacity = HASH_OPEN_GROUP_WIDTH;
+
+    if (size < 0 || hashfun == NULL || keycmp == NULL)
+        return NULL;
+
+    while (capacity - capacity / 8 < size)
+    {
+        capacity <<= 1;
+    }
+
+    table = HASH_OPEN_MALLOC(sizeof(*table));
+    if (table == NULL)
+        return NULL;
+
+    memset(&table->conf, 0, sizeof(table->conf));
+    table->conf.hashfun    = hashfun;
+    table->conf.keycmp     = keycmp;
+    table->conf.valuefree  = valuefree;
+    table->conf.keylen     = 0;
+    table->conf.seed       = hash_table_seed_creat(table);
+    table->conf.rehash_idx = -1;
+
+    table->num   = 0;
+    table->ctrl  = NULL;
+    table->slots = NULL;
+    if (hash_open_rehash(table, capacity) != 0)
+    {
+        HASH_OPEN_FREE(table);
+        return NULL;
+    }
+
+    return table;
+}
+
+/**
+ * 使用与hash_table_creat_default相同的默认哈希函数、key比较函数(key为字符串) 动态创建一个开放寻址哈希表.
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct hash_open *hash_open_creat_default(int size, node_value_free valuefree)
+{
+    return hash_open_creat(size, hash_table_hash_default, hash_table_keycmp_default, valuefree);
+}
+
+/**
+ * 使用默认的哈希函数、key比较函数 动态创建一个key为keylen字节二进制数据的开放寻址哈希表.
+ *
+ * @param keylen: key的字节数
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct hash_open *hash_open_creat_binary(int size, int keylen, node_value_free valuefree)
+{
+    struct hash_open *table = NULL;
+
+    if (keylen <= 0)
+        return NULL;
+
+    table = hash_open_creat(size, hash_table_hash_default, hash_table_keycmp_default, valuefree);
+    if (table != NULL)
+        table->conf.keylen = keylen;
+
+    return table;
+}
+
+/**
+ * 插入一个数据.没有空槽时,已删除的槽较多则原大小重建,否则扩容为原来的2倍.
+ *
+ * @param table: 散列表
+ * @param key: 关键值
+ * @param value: 数据
+ *
+ * @return 0:插入成功
+ *        -1:哈希表不存在 或 key为空 或 value为空
+ *        -2:节点已经存在
+ *        -3:扩容空间申请失败
+ */
+int hash_open_insert(struct hash_open *table, void *key, void *value)
+{
+    unsigned int hash = 0;
+    int capacity = 0, pos = 0;
+
+    if (table == NULL || key == NULL || value == NULL)
+        return -1;
+
+    hash = table->conf.hashfun(&table->conf, key);
+    if (hash_open_find(table, key, hash) >= 0)
+        return -2;
+
+    if (table->growth_left == 0)
+    {
+        capacity = table->capacity;
+        if (table->num * 32 > capacity * 25)
+            capacity *= 2;
+        if (hash_open_rehash(table, capacity) != 0)
+            return -3;
+    }
+
+    pos = hash_open_find_free(table, hash);
+    if (table->ctrl[pos] == HASH_OPEN_CTRL_EMPTY)
+        table->growth_left--;
+
+    table->ctrl[pos] = (signed char)(hash & 0x7F);
+    table->slots[pos].key = key;
+    table->slots[pos].value = value;
+    table->num++;
+
+    return 0;
+}
+
+/**
+ * 删除一个数据.如果所在组中还有空槽,说明查找不会越过该组,可以直接标记为空槽,否则标记为已删除.
+ *
+ * @param table: 散列表
+ * @param key: 删除数据关键值
+ *
+ * @return 0:删除成功
+ *        -1:哈希表不存在 或 key为空
+ *        -2:节点不存在
+ */
+int hash_open_delete(struct hash_open *table, void *key)
+{
+    const signed char *group = NULL;
+    int pos = 0;
+
+    if (table == NULL || key == NULL)
+        return -1;
+
+    pos = hash_open_find(table, key, table->conf.hashfun(&table->conf, key));
+    if (pos < 0)
+        return -2;
+
+    hash_open_slot_free(table, pos);
+
+    group = table->ctrl + (pos & ~(HASH_OPEN_GROUP_WIDTH - 1));
+    if (hash_open_group_match(group, HASH_OPEN_CTRL_EMPTY) != 0)
+    {
+        table->ctrl[pos] = HASH_OPEN_CTRL_EMPTY;
+        table->growth_left++;
+    }
+    else
+    {
+        table->ctrl[pos] = HASH_OPEN_CTRL_DELETED;
+    }
+    table->num--;
+
+    return 0;
+}
+
+/**
+ * 修改一个数据.会先释放旧的数据空间,修改的数据必须为新动态分配的空间.
+ *
+ * @param table: 散列表
+ * @param key: 修改数据关键值
+ * @param value: 修改的数据
+ *
+ * @return 0:修改成功
+ *        -1:哈希表不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ */
+int hash_open_modify(struct hash_open *table, void *key, void *value)
+{
+    int pos = 0;
+
+    if (table == NULL || key == NULL || value == NULL)
+        return -1;
+
+    pos = hash_open_find(table, key, table->conf.hashfun(&table->conf, key));
+    if (pos < 0)
+        return -2;
+
+    hash_open_slot_free(table, pos);
+    table->slots[pos].key = key;
+    table->slots[pos].value = value;
+
+    return 0;
+}
+
+/**
+ * 根据key查找数据.
+ *
+ * @param table: 散列表
+ * @param key: 查找数据关键值
+ *
+ * @return NULL:查找失败
+ *        !NULL:查找成功
+ */
+void * hash_open_search(struct hash_open *table, void *key)
+{
+    int pos = 0;
+
+    if (table == NULL || key == NULL)
+        return NULL;
+
+    pos = hash_open_find(table, key, table->conf.hashfun(&table->conf, key));
+    if (pos < 0)
+        return NULL;
+
+    return table->slots[pos].value;
+}
+
+/**
+ * 销毁哈希表,会对每个数据调用valuefree.
+ *
+ * @param table: 散列表
+ */
+void hash_open_destroy(struct hash_open **table)
+{
+    int i = 0;
+
+    if (table == NULL || *table == NULL)
+        return;
+
+    if ((*table)->conf.valuefree != NULL)
+    {
+        for (i = 0; i < (*table)->capacity; i++)
+        {
+            if ((*table)->ctrl[i] >= 0)
+                hash_open_slot_free(*table, i);
+        }
+    }
+
+    HASH_OPEN_FREE((*table)->ctrl);
+    HASH_OPEN_FREE((*table)->slots);
+    HASH_OPEN_FREE(*table);
+    *table = NULL;
+}
+
+
+/*引擎接口,参数类型为void *的转接函数*/
+static void *hash_open_ops_creat(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree)
+{
+    return hash_open_creat(size, hashfun, keycmp, valuefree);
+}
+
+static void *hash_open_ops_creat_default(int size, node_value_free valuefree)
+{
+    return hash_open_creat_default(size, valuefree);
+}
+
+static void *hash_open_ops_creat_binary(int size, int keylen, node_value_free valuefree)
+{
+    return hash_open_creat_binary(size, keylen, valuefree);
+}
+
+static int hash_open_ops_insert(void *table, void *key, void *value)
+{
+    return hash_open_insert(table, key, value);
+}
+
+static int hash_open_ops_delete(void *table, void *key)
+{
+    return hash_open_delete(table, key);
+}
+
+static int hash_open_ops_modify(void *table, void *key, void *value)
+{
+    return hash_open_modify(table, key, value);
+}
+
+static void *hash_open_ops_search(void *table, void *key)
+{
+    return hash_open_search(table, key);
+}
+
+static void hash_open_ops_destroy(void *table)
+{
+    struct hash_open *open = table;
+
+    hash_open_destroy(&open);
+}
+
+/*开放寻址哈希表引擎*/
+const struct hash_table_ops hash_open_ops =
+{
+    hash_open_ops_creat,
+    hash_open_ops_creat_default,
+    hash_open_ops_creat_binary,
+    hash_open_ops_insert,
+    hash_open_ops_delete,
+    hash_open_ops_modify,
+    hash_open_ops_search,
+    hash_open_ops_destroy,
+};
+
+
+/*******************************************************************************************
+ *                                          使用示例
+ *******************************************************************************************/
+struct open_test_node
+{
+    char key[10];
+    char value[10];
+};
+
+static int open_value_free_sample(struct hash_table_node *node)
+{
+    /*与hash_table相同,根据key找到实际指向的结构体首地址*/
+    HASH_OPEN_FREE(container(node->key, struct open_test_node, key));
+
+    return 0;
+}
+
+struct hash_open *hash_open_test;
+char open_node_read[5][10];
+
+void hash_open_sample(void)
+{
+    int i = 0;
+    struct open_test_node *node_temp = NULL;
+    char rd_key[10] = {0}, del_key[10] = {0};
+    char *temp = NULL;
+
+    hash_open_test = hash_open_creat_default(5, open_value_free_sample);
+
+    /*插入 -- 查询*/
+    for (i=0; i<5; i++)
+    {
+        node_temp = HASH_OPEN_MALLOC(sizeof(*node_temp));
+        memset(node_temp, 0, sizeof(*node_temp));
+        sprintf(node_temp->key, "AAA%d", i);
+        sprintf(node_temp->value, "%d", i+10);
+        hash_open_insert(hash_open_test, node_temp->key, node_temp->value);
+    }
+    for (i=0; i<5; i++)
+    {
+        sprintf(rd_key, "AAA%d", i);
+        temp = hash_open_search(hash_open_test, rd_key);
+        memcpy(open_node_read[i], temp, 10);
+    }
+
+    /*修改 -- 查询*/
+    for (i=0; i<5; i++)
+    {
+        node_temp = HASH_OPEN_MALLOC(sizeof(*node_temp));
+        memset(node_temp, 0, sizeof(*node_temp));
+        sprintf(node_temp->key, "AAA%d", i);
+        sprintf(node_temp->value, "%d", i+20);
+        hash_open_modify(hash_open_test, node_temp->key, node_temp->value);
+    }
+    for (i=0; i<5; i++)
+    {
+        sprintf(rd_key, "AAA%d", i);
+        temp = hash_open_search(hash_open_test, rd_key);
+        memcpy(open_node_read[i], temp, 10);
+    }
+
+    /*删除 -- 查询*/
+    for (i=0; i<3; i++)
+    {
+        sprintf(del_key, "AAA%d", i);
+        hash_open_delete(hash_open_test, del_key);
+    }
+    for (i=0; i<5; i++)
+    {
+        memset(open_node_read[i], 0, 10);
+        sprintf(rd_key, "AAA%d", i);
+        temp = hash_open_search(hash_open_test, rd_key);
+        if (temp != NULL)
+        {
+            memcpy(open_node_read[i], temp, 10);
+        }
+    }
+
+    hash_open_destroy(&hash_open_test);
+}
+
+
+/*******************************************************************************************
+ *                                   与链式哈希表查找对比
+ *******************************************************************************************/
+/*
+ * 数据个数,哈希表总大小需要远大于最后一级cache,查找时间才主要由cache miss决定.
+ * 链式哈希表每次查找访问哈希桶数组和节点(不在同一cache line),开放寻址哈希表访问控制字节组和槽数组
+ */
+#define HASH_OPEN_BENCH_NUM     (1 << 18)
+#define HASH_OPEN_BENCH_ROUNDS  4
+
+/*
+ * 通过hash_table_ops用同一段代码测试两种引擎,key为4字节二进制数据,乱序插入后乱序查找
+ * [0]:hash_table [1]:hash_open, [x][0]:插入耗时 [x][1]:HASH_OPEN_BENCH_ROUNDS轮查找(命中)耗时 [x][2]:同样次数查找(不命中)耗时(tick)
+ */
+rt_tick_t hash_open_bench_ticks[2][3];
+volatile unsigned int hash_open_bench_sink;
+
+void hash_open_bench(void)
+{
+    const struct hash_table_ops *ops[2] = {&hash_table_chain_ops, &hash_open_ops};
+    unsigned int *keys = NULL, *misses = NULL;
+    unsigned int seed = 1, sum = 0, t = 0;
+    rt_tick_t start = 0;
+    void *table = NULL;
+    int e = 0, i = 0, j = 0, r = 0;
+
+    keys = HASH_OPEN_MALLOC(HASH_OPEN_BENCH_NUM * sizeof(*keys));
+    if (keys == NULL)
+        return;
+    misses = HASH_OPEN_MALLOC(HASH_OPEN_BENCH_NUM * sizeof(*misses));
+    if (misses == NULL)
+    {
+        HASH_OPEN_FREE(keys);
+        return;
+    }
+
+    /*偶数key插入,奇数key用于不命中的查找,都打乱顺序*/
+    for (i = 0; i < HASH_OPEN_BENCH_NUM; i++)
+    {
+        keys[i] = i * 2;
+        misses[i] = i * 2 + 1;
+    }
+    for (i = HASH_OPEN_BENCH_NUM - 1; i > 0; i--)
+    {
+        seed = seed * 1103515245 + 12345;
+        j = (seed >> 8) % (i + 1);
+        t = keys[i]; keys[i] = keys[j]; keys[j] = t;
+        t = misses[i]; misses[i] = misses[j]; misses[j] = t;
+    }
+
+    for (e = 0; e < 2; e++)
+    {
+        /*按默认大小创建,插入过程中包括扩容*/
+        table = ops[e]->creat_binary(16, sizeof(unsigned int), NULL);
+        if (table == NULL)
+            continue;
+
+        start = rt_tick_get();
+        for (i = 0; i < HASH_OPEN_BENCH_NUM; i++)
+        {
+            ops[e]->insert(table, &keys[i], &keys[i]);
+        }
+        hash_open_bench_ticks[e][0] = rt_tick_get() - start;
+
+        start = rt_tick_get();
+        for (r = 0; r < HASH_OPEN_BENCH_ROUNDS; r++)
+        {
+            for (i = 0; i < HASH_OPEN_BENCH_NUM; i++)
+            {
+                sum += *(unsigned int *)ops[e]->search(table, &keys[(i + r * 7919) & (HASH_OPEN_BENCH_NUM - 1)]);
+            }
+        }
+        hash_open_bench_ticks[e][1] = rt_tick_get() - start;
+
+        start = rt_tick_get();
+        for (r = 0; r < HASH_OPEN_BENCH_ROUNDS; r++)
+        {
+            for (i = 0; i < HASH_OPEN_BENCH_NUM; i++)
+            {
+                sum += (ops[e]->search(table, &misses[i]) != NULL);
+            }
+        }
+        hash_open_bench_ticks[e][2] = rt_tick_get() - start;
+
+        ops[e]->destroy(table);
+    }
+
+    hash_open_bench_sink = sum;
+    HASH_OPEN_FREE(keys);
+    HASH_OPEN_FREE(misses);
+}
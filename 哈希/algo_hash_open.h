@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   share hash_table callbacks, default hash and ops table
+ */
+
+#ifndef __ALGO_HASH_OPEN_H__
+#define __ALGO_HASH_OPEN_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rtthread.h>
+#include "algo_hash_table.h"
+
+#define HASH_OPEN_MALLOC(size)    rt_malloc(size);
+#define HASH_OPEN_FREE(p)         rt_free(p);
+
+/*
+ * 开放寻址哈希表(Swiss table).节点数据直接存放在连续的槽数组中,插入不需要申请节点空间;
+ * 每个槽对应一个控制字节,查找时一次比较一组(16个)控制字节,只有控制字节匹配的槽才比较key.
+ * 控制字节: EMPTY-空槽 DELETED-已删除 0~127-有数据,值为哈希值的低7位
+ */
+#define HASH_OPEN_GROUP_WIDTH  16
+#define HASH_OPEN_CTRL_EMPTY   ((signed char)-128)
+#define HASH_OPEN_CTRL_DELETED ((signed char)-2)
+
+struct hash_open;
+
+struct hash_open_slot
+{
+    void *key;
+    void *value;
+};
+
+/*
+ * 哈希函数、key比较、数据删除使用与hash_table相同的回调(hash_fun/hash_keycmp/node_value_free),
+ * 同一组回调可以用于两种引擎.回调的table参数为&conf,conf中只有hashfun/keycmp/valuefree/keylen/seed有效;
+ * valuefree的node参数为临时节点,key/value为槽中的数据.
+ */
+struct hash_open
+{
+    int capacity;    /*槽的个数,为2的幂且不小于HASH_OPEN_GROUP_WIDTH*/
+    int num;         /*有数据的槽个数*/
+    int growth_left; /*还可以使用的空槽个数,为0时扩容或清理已删除的槽*/
+    struct hash_table conf; /*回调函数和默认哈希函数使用的参数*/
+    signed char           *ctrl;    /*控制字节数组*/
+    struct hash_open_slot *slots;   /*槽数组*/
+};
+
+extern struct hash_open *hash_open_creat(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree);
+extern struct hash_open *hash_open_creat_default(int size, node_value_free valuefree);
+extern struct hash_open *hash_open_creat_binary(int size, int keylen, node_value_free valuefree);
+extern int    hash_open_insert(struct hash_open *table, void *key, void *value);
+extern int    hash_open_delete(struct hash_open *table, void *key);
+extern int    hash_open_modify(struct hash_open *table, void *key, void *value);
+extern void * hash_open_search(struct hash_open *table, void *key);
+extern void   hash_open_destroy(struct hash_open **table);
+
+extern const struct hash_table_ops hash_open_ops;
+
+extern void hash_open_sample(void);
+extern void hash_open_bench(void);
+
+#endif
@@ -4,296 +4,1301 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-12-27     denghengli   the first version
+ * 2026-10-17     denghengli   incremental rehash driven by load factor
+ * 2026-10-17     denghengli   cache the full hash in each node
+ * 2026-10-17     denghengli   seeded word-at-a-time default hash, binary keys, power-of-two buckets
+ * 2026-10-17     denghengli   batched search/insert with software prefetch
+ * 2026-10-17     denghengli   per-table node pool and hash_table_destroy
+ * 2026-10-17     denghengli   cursor scan, clear and bulk export
+ * 2026-10-17     denghengli   chain length and probe statistics (HASH_TABLE_USING_STATS)
+ * 2026-10-17     denghengli   engine ops table shared with hash_open
  */
 
 #include "algo_hash_table.h"
 
+/*wyhash使用的常数*/
+#define HASH_SECRET0 0xa0761d6478bd642fULL
+#define HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+
+/**
+ * 64位乘法,得到128位结果的低64位存放在a,高64位存放在b.
+ */
+static void hash_mum(unsigned long long *a, unsigned long long *b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)(*a) * (*b);
+
+    *a = (unsigned long long)r;
+    *b = (unsigned long long)(r >> 64);
+#else
+    /*没有128位整数的平台(如32位MCU)拆成4个32x32位乘法*/
+    unsigned long long ha = *a >> 32, hb = *b >> 32, la = (unsigned int)*a, lb = (unsigned int)*b;
+    unsigned long long rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    unsigned long long t = rl + (rm0 << 32), c = (t < rl), lo = 0, hi = 0;
+
+    lo = t + (rm1 << 32);
+    c += (lo < t);
+    hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    *a = lo;
+    *b = hi;
+#endif
+}
+
+/**
+ * 乘法混合,返回128位乘积的高低64位异或.
+ */
+static unsigned long long hash_mix(unsigned long long a, unsigned long long b)
+{
+    hash_mum(&a, &b);
+    return a ^ b;
+}
+
+/*按小端读取,memcpy可以保证在不支持非对齐访问的平台上也能正确读取*/
+static unsigned long long hash_read64(const unsigned char *p)
+{
+    unsigned long long v = 0;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static unsigned long long hash_read32(const unsigned char *p)
+{
+    unsigned int v = 0;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+/**
+ * 内置的哈希函数(wyhash).每次读取8字节,长key每轮处理48字节,seed不同时同一个key的哈希值也不同,
+ * 可以避免针对固定哈希函数构造大量冲突key的攻击.
+ * 
+ * @param key: 关键值
+ * @param len: key的字节数
+ * @param seed: 哈希种子
+ * 
+ * @return 32位哈希值
+ */
+unsigned int hash_table_hash_bytes(const void *key, int len, unsigned int seed)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    unsigned long long s = seed, see1 = 0, see2 = 0, a = 0, b = 0, h = 0;
+    int i = len;
+
+    s ^= hash_mix(s ^ HASH_SECRET0, HASH_SECRET1);
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            a = (hash_read32(p) << 32) | hash_read32(p + ((len >> 3) << 2));
+            b = (hash_read32(p + len - 4) << 32) | hash_read32(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0)
+        {
+            a = ((unsigned long long)p[0] << 16) | ((unsigned long long)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        }
+    }
+    else
+    {
+        if (i > 48)
+        {
+            see1 = s;
+            see2 = s;
+            do
+            {
+                s    = hash_mix(hash_read64(p) ^ HASH_SECRET1, hash_read64(p + 8) ^ s);
+                see1 = hash_mix(hash_read64(p + 16) ^ HASH_SECRET2, hash_read64(p + 24) ^ see1);
+                see2 = hash_mix(hash_read64(p + 32) ^ HASH_SECRET0, hash_read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            s ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            s = hash_mix(hash_read64(p) ^ HASH_SECRET1, hash_read64(p + 8) ^ s);
+            p += 16;
+            i -= 16;
+        }
+        a = hash_read64(p + i - 16);
+        b = hash_read64(p + i - 8);
+    }
+
+    a ^= HASH_SECRET1;
+    b ^= s;
+    hash_mum(&a, &b);
+    h = hash_mix(a ^ HASH_SECRET0 ^ (unsigned long long)len, b ^ HASH_SECRET1);
+
+    return (unsigned int)(h ^ (h >> 32));
+}
+
+/**
+ * 默认使用的哈希函数.keylen为0时key为字符串,否则为keylen字节的二进制数据;
+ * 返回完整的32位哈希值,由哈希表根据当前哈希桶大小取低位.
+ * 
+ * @return 哈希值
+ */
+unsigned int hash_table_hash_default(struct hash_table *table, const void *key)
+{
+    int len = table->keylen;
+
+    if (len == 0)
+        len = strlen((const char *)key);
+
+    return hash_table_hash_bytes(key, len, table->seed);
+}
+
+/**
+ * 哈希key比较, key_cmp:传入的要比较的key, key_becmp:哈希表中被比较的key
+ * 
+ * @return > 0 : key_cmp > key_becmp
+ * @return = 0 : key_cmp = key_becmp
+ * @return < 0 : key_cmp < key_becmp
+ * 
+ */
+int hash_table_keycmp_default(struct hash_table *table, const void *key_cmp, const void *key_becmp)
+{
+    if (table->keylen == 0)
+        return strcmp(key_cmp, key_becmp);
+
+    return memcmp(key_cmp, key_becmp, table->keylen);
+}
+
+/**
+ * 为每个哈希表生成不同的哈希种子.
+ * 
+ * @param owner: 哈希表地址,参与种子计算
+ */
+unsigned int hash_table_seed_creat(const void *owner)
+{
+    static unsigned int counter = 0;
+    unsigned long long a = (unsigned long long)(unsigned long)owner ^ ((unsigned long long)HASH_TABLE_RANDOM_SEED() << 32);
+    unsigned long long b = HASH_SECRET2 + (++counter);
+
+    a = hash_mix(a, b);
+    return (unsigned int)(a ^ (a >> 32));
+}
+
+/**
+ * 不小于size的最小的2的幂.
+ */
+static int hash_table_size_pow2(int size)
+{
+    int pow2 = 1;
+
+    while (pow2 < size)
+    {
+        pow2 <<= 1;
+    }
+
+    return pow2;
+}
+
+/**
+ * 申请size大小的哈希桶(数组)空间,并清零.
+ * 
+ * @return NULL:申请失败
+ *        !NULL:申请成功
+ */
+static struct hash_table_node **hash_table_buckets_creat(int size)
+{
+    struct hash_table_node **tables = NULL;
+    int i = 0;
+
+    tables = (struct hash_table_node**)HASH_TABLE_MALLOC(size * sizeof(*tables));
+    if (tables == NULL)
+        return NULL;
+
+    for (i = 0; i < size; i++)
+    {
+        tables[i] = NULL;
+    }
+
+    return tables;
+}
+
+/**
+ * 动态创建一个哈希表.
+ * 
+ * @param size: 哈希桶的初始大小,也是缩容的下限,会向上取整为2的幂
+ * @param hashfun: 哈希函数,返回完整的32位哈希值
+ * 
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct hash_table *hash_table_creat(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree)
+{
+    struct hash_table *hashtable = NULL;
+    struct hash_table_node **tables = NULL;
+
+    if (size <= 0 || hashfun == NULL || keycmp == NULL)
+        return NULL;
+
+    /*哈希桶大小为2的幂,取模可以用 & (size - 1) 代替*/
+    size = hash_table_size_pow2(size);
+
+    /*申请哈希表结构空间*/
+    hashtable = HASH_TABLE_MALLOC(sizeof(*hashtable));
+    if (hashtable == NULL)
+        return NULL;
+    
+    /*申请哈希桶数据空间,实际就是申请size大小的数组空间*/
+    tables = hash_table_buckets_creat(size);
+    if (tables == NULL)
+    {
+        HASH_TABLE_FREE(hashtable);
+        return NULL;
+    }
+
+    hashtable->num       = 0;
+    hashtable->size      = size;
+    hashtable->tables    = tables;
+    hashtable->hashfun   = hashfun;
+    hashtable->keycmp    = keycmp;
+    hashtable->valuefree = valuefree;
+    hashtable->keylen    = 0;
+    hashtable->seed      = hash_table_seed_creat(hashtable);
+
+    hashtable->rehash_size   = 0;
+    hashtable->rehash_idx    = -1;
+    hashtable->rehash_tables = NULL;
+    hashtable->min_size      = size;
+    hashtable->load_factor   = HASH_TABLE_LOAD_FACTOR;
+    hashtable->shrink_factor = HASH_TABLE_SHRINK_FACTOR;
+
+    hashtable->pool_chunk_num = HASH_TABLE_POOL_CHUNK_NUM;
+    hashtable->pool_free      = NULL;
+    hashtable->pool_chunks    = NULL;
+
+    hash_table_stats_reset(hashtable);
+    
+    return hashtable;
+}
+
+/**
+ * 使用默认的函数函数、key比较函数、节点删除函数 动态创建一个哈希表.
+ * 
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct hash_table *hash_table_creat_default(int size, node_value_free valuefree)
+{
+    return hash_table_creat(size, hash_table_hash_default, hash_table_keycmp_default, valuefree);
+}
+
+/**
+ * 使用默认的哈希函数、key比较函数 动态创建一个key为keylen字节二进制数据的哈希表.
+ * 
+ * @param keylen: key的字节数
+ * 
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct hash_table *hash_table_creat_binary(int size, int keylen, node_value_free valuefree)
+{
+    struct hash_table *hashtable = NULL;
+
+    if (keylen <= 0)
+        return NULL;
+
+    hashtable = hash_table_creat(size, hash_table_hash_default, hash_table_keycmp_default, valuefree);
+    if (hashtable != NULL)
+        hashtable->keylen = keylen;
+
+    return hashtable;
+}
+
+/**
+ * 设置哈希表扩容、缩容的负载因子,负载因子为 节点个数*100/哈希桶大小.
+ * 
+ * @param hashtable: 散列表
+ * @param load_factor: 负载因子达到该值时扩容为原来的2倍, 0:不扩容
+ * @param shrink_factor: 负载因子低于该值时缩容(不小于创建时的大小), 0:不缩容
+ * 
+ * @return 0:设置成功
+ *        -1:哈希表不存在 或 负载因子无效
+ */
+int hash_table_set_load_factor(struct hash_table *hashtable, int load_factor, int shrink_factor)
+{
+    if (hashtable == NULL || load_factor < 0 || shrink_factor < 0)
+        return -1;
+
+    /*缩容后的负载因子为50%,缩容阈值不能让缩容后马上又触发扩容*/
+    if ((load_factor > 0) && (shrink_factor * 2 >= load_factor))
+        return -1;
+
+    hashtable->load_factor   = load_factor;
+    hashtable->shrink_factor = shrink_factor;
+
+    return 0;
+}
+
+/**
+ * 设置哈希表节点池每次申请的节点个数,只能在哈希表为空时设置.
+ * 
+ * @param hashtable: 散列表
+ * @param chunk_num: 节点池每块包含的节点个数, 0:不使用节点池,每个节点单独申请和释放
+ * 
+ * @return 0:设置成功
+ *        -1:哈希表不存在 或 chunk_num无效
+ *        -2:哈希表不为空
+ */
+int hash_table_set_pool(struct hash_table *hashtable, int chunk_num)
+{
+    struct hash_table_chunk *chunk = NULL;
+
+    if (hashtable == NULL || chunk_num < 0)
+        return -1;
+
+    if (hashtable->num != 0)
+        return -2;
+
+    /*表为空时块中的节点都在空闲链表中,可以直接释放*/
+    while ((chunk = hashtable->pool_chunks) != NULL)
+    {
+        hashtable->pool_chunks = chunk->next;
+        HASH_TABLE_FREE(chunk);
+    }
+    hashtable->pool_free = NULL;
+    hashtable->pool_chunk_num = chunk_num;
+
+    return 0;
+}
+
+/**
+ * 从节点池中获取一个节点.空闲链表为空时一次申请pool_chunk_num个节点的块,
+ * 插入/删除稳定后节点都从空闲链表中获取,不再调用内存分配函数.
+ * 
+ * @return NULL:空间申请失败
+ *        !NULL:节点
+ */
+static struct hash_table_node *hash_table_node_alloc(struct hash_table *hashtable)
+{
+    struct hash_table_chunk *chunk = NULL;
+    struct hash_table_node *node = NULL;
+    int i = 0;
+
+    if (hashtable->pool_chunk_num == 0)
+    {
+        node = (struct hash_table_node*)HASH_TABLE_MALLOC(sizeof(*node));
+        return node;
+    }
+
+    if (hashtable->pool_free == NULL)
+    {
+        chunk = (struct hash_table_chunk *)HASH_TABLE_MALLOC(sizeof(*chunk) + hashtable->pool_chunk_num * sizeof(chunk->nodes[0]));
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->next = hashtable->pool_chunks;
+        hashtable->pool_chunks = chunk;
+        for (i = hashtable->pool_chunk_num - 1; i >= 0; i--)
+        {
+            chunk->nodes[i].next = hashtable->pool_free;
+            hashtable->pool_free = &chunk->nodes[i];
+        }
+    }
+
+    node = hashtable->pool_free;
+    hashtable->pool_free = node->next;
+
+    return node;
+}
+
+/**
+ * 将节点放回节点池.
+ */
+static void hash_table_node_free(struct hash_table *hashtable, struct hash_table_node *node)
+{
+    if (hashtable->pool_chunk_num == 0)
+    {
+        HASH_TABLE_FREE(node);
+        return;
+    }
+
+    node->next = hashtable->pool_free;
+    hashtable->pool_free = node;
+}
+
 /**
- * 默认使用的哈希函数.
+ * 在一个哈希桶中查找key.hash桶中的元素先按完整哈希值、再按key从小到大排列,
+ * 只有哈希值相等时才需要调用keycmp比较key.
+ * 
+ * @param hashtable: 散列表
+ * @param cur: 哈希桶的头节点
+ * @param key: 关键值
+ * @param hash: key的完整哈希值
+ * @param prev: 返回key所在节点(或key应插入位置)的前驱节点,NULL表示头结点
+ * 
+ * @return NULL:节点不存在
+ *        !NULL:key所在的节点
+ */
+static struct hash_table_node *hash_table_bucket_find(struct hash_table *hashtable, struct hash_table_node *cur, const void *key,
+                                                      unsigned int hash, struct hash_table_node **prev)
+{
+    int res = 0;
+
+    *prev = NULL;
+    while (cur != NULL)
+    {
+        HASH_TABLE_STAT_ADD(hashtable->stat_cmps, 1);
+        if (cur->hash != hash)
+            res = (hash > cur->hash) ? 1 : -1;
+        else
+            res = hashtable->keycmp(hashtable, key, cur->key);
+
+        if (res == 0)
+            return cur;
+        if (res < 0)
+            break;
+
+        *prev = cur;
+        cur = cur->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * 将节点链接到哈希桶中prev之后,prev为NULL表示插入到头结点.
+ */
+static void hash_table_bucket_link(struct hash_table_node **bucket, struct hash_table_node *prev, struct hash_table_node *node)
+{
+    if (prev == NULL)
+    {
+        node->next = *bucket;
+        *bucket = node;
+    }
+    else
+    {
+        node->next = prev->next;
+        prev->next = node;
+    }
+}
+
+/**
+ * 在哈希表中查找key.迁移过程中key可能在旧哈希桶,也可能在新哈希桶中.
+ * 
+ * @param hashtable: 散列表
+ * @param key: 关键值
+ * @param hash: key的完整哈希值
+ * @param bucket: 返回key所在的哈希桶; 节点不存在时为新节点应插入的哈希桶(迁移过程中为新哈希桶)
+ * @param prev: 返回key所在节点(或key应插入位置)的前驱节点
+ * 
+ * @return NULL:节点不存在
+ *        !NULL:key所在的节点
+ */
+static struct hash_table_node *hash_table_find(struct hash_table *hashtable, const void *key, unsigned int hash,
+                                               struct hash_table_node ***bucket, struct hash_table_node **prev)
+{
+    struct hash_table_node *node = NULL;
+
+    HASH_TABLE_STAT_ADD(hashtable->stat_searches, 1);
+    *bucket = &hashtable->tables[hash & (hashtable->size - 1)];
+    node = hash_table_bucket_find(hashtable, **bucket, key, hash, prev);
+    if ((node == NULL) && HASH_TABLE_IS_REHASHING(hashtable))
+    {
+        *bucket = &hashtable->rehash_tables[hash & (hashtable->rehash_size - 1)];
+        node = hash_table_bucket_find(hashtable, **bucket, key, hash, prev);
+    }
+
+    return node;
+}
+
+/**
+ * 渐进式迁移:从旧哈希桶中迁移steps个非空的桶到新哈希桶,全部迁移完成后用新哈希桶替换旧哈希桶.
+ * 为了不让一次操作耗时过长,最多只访问steps*10个空桶.节点中保存了完整哈希值,迁移时不需要重新计算.
+ */
+static void hash_table_rehash_step(struct hash_table *hashtable, int steps)
+{
+    struct hash_table_node *cur = NULL;
+    struct hash_table_node *next = NULL;
+    struct hash_table_node *prev = NULL;
+    struct hash_table_node **bucket = NULL;
+    int empty_visits = steps * 10;
+#ifdef HASH_TABLE_USING_STATS
+    unsigned long cmps = hashtable->stat_cmps; /*迁移时访问的节点不计入查找统计*/
+#endif
+
+    if (!HASH_TABLE_IS_REHASHING(hashtable))
+        return;
+
+    while ((steps > 0) && (hashtable->rehash_idx < hashtable->size))
+    {
+        cur = hashtable->tables[hashtable->rehash_idx];
+        if (cur == NULL)
+        {
+            hashtable->rehash_idx++;
+            if (--empty_visits == 0)
+                break;
+            continue;
+        }
+
+        /*将该桶中的节点逐个按顺序插入到新哈希桶中*/
+        while (cur != NULL)
+        {
+            next = cur->next;
+            bucket = &hashtable->rehash_tables[cur->hash & (hashtable->rehash_size - 1)];
+            hash_table_bucket_find(hashtable, *bucket, cur->key, cur->hash, &prev);
+            hash_table_bucket_link(bucket, prev, cur);
+            cur = next;
+        }
+        hashtable->tables[hashtable->rehash_idx] = NULL;
+        hashtable->rehash_idx++;
+        steps--;
+    }
+#ifdef HASH_TABLE_USING_STATS
+    hashtable->stat_cmps = cmps;
+#endif
+
+    /*迁移完成*/
+    if (hashtable->rehash_idx >= hashtable->size)
+    {
+        HASH_TABLE_FREE(hashtable->tables);
+        hashtable->tables        = hashtable->rehash_tables;
+        hashtable->size          = hashtable->rehash_size;
+        hashtable->rehash_tables = NULL;
+        hashtable->rehash_size   = 0;
+        hashtable->rehash_idx    = -1;
+    }
+}
+
+/**
+ * 根据负载因子判断是否需要扩容或缩容,需要则申请新哈希桶并开始渐进式迁移.
+ * 新哈希桶申请失败时不做处理,下次插入/删除时会再次尝试.
+ */
+static void hash_table_resize_check(struct hash_table *hashtable)
+{
+    long load = 0;
+    int size = 0;
+
+    if (HASH_TABLE_IS_REHASHING(hashtable))
+        return;
+
+    load = (long)hashtable->num * 100 / hashtable->size;
+    if ((hashtable->load_factor > 0) && (load >= hashtable->load_factor))
+    {
+        size = hashtable->size * 2;
+    }
+    else if ((hashtable->shrink_factor > 0) && (load < hashtable->shrink_factor) && (hashtable->size > hashtable->min_size))
+    {
+        /*缩容到负载因子不超过50%,但不小于创建时的大小*/
+        size = hash_table_size_pow2(hashtable->num * 2);
+        if (size < hashtable->min_size)
+            size = hashtable->min_size;
+    }
+
+    if ((size <= 0) || (size == hashtable->size))
+        return;
+
+    hashtable->rehash_tables = hash_table_buckets_creat(size);
+    if (hashtable->rehash_tables == NULL)
+        return;
+
+    hashtable->rehash_size = size;
+    hashtable->rehash_idx  = 0;
+    if (size > hashtable->size)
+        HASH_TABLE_STAT_ADD(hashtable->stat_grows, 1);
+    else
+        HASH_TABLE_STAT_ADD(hashtable->stat_shrinks, 1);
+}
+
+
+/**
+ * 按已经计算好的哈希值插入一个节点.
+ * 
+ * @return 0:插入成功
+ *        -2:节点已经存在
+ *        -3:节点空间申请失败
+ */
+static int hash_table_insert_hash(struct hash_table *hashtable, void *key, void *value, unsigned int hash)
+{
+    struct hash_table_node **bucket = NULL;
+    struct hash_table_node *prev = NULL;
+    struct hash_table_node *new_node = NULL;
+
+    /*如果key相同,表示节点以及存在,直接返回*/
+    if (hash_table_find(hashtable, key, hash, &bucket, &prev) != NULL)
+        return -2;
+
+    /*插入新增节点*/
+    new_node = hash_table_node_alloc(hashtable);
+    if (new_node == NULL)
+        return -3;
+
+    new_node->key = key;
+    new_node->value = value;
+    new_node->hash = hash;
+    hash_table_bucket_link(bucket, prev, new_node);
+    
+    hashtable->num ++;
+    hash_table_resize_check(hashtable);
+
+    return 0;
+}
+
+/**
+ * 向一个哈希桶插入一个节点,有3种情况:
+ * 1、prev==NULL,插入位置是头结点 2、key小于cur->key 3、cur==NULL,链表尾插入
+ * 迁移过程中新节点插入到新哈希桶中
+ * 
+ * @param hashtable: 散列表
+ * @param key: 关键值
+ * @param value: 节点数据
+ * 
+ * @return 0:插入成功
+ *        -1:哈希表不存在 或 key为空 或 value为空
+ *        -2:节点已经存在
+ *        -3:节点空间申请失败
+ */
+int hash_table_insert(struct hash_table *hashtable, void *key, void *value)
+{
+    unsigned int hash = 0;
+
+    if (hashtable == NULL || key == NULL || value == NULL)
+        return -1;
+
+    /*根据key计算出哈希值*/
+    hash = hashtable->hashfun(hashtable, key);
+    hash_table_rehash_step(hashtable, HASH_TABLE_REHASH_STEP);
+
+    return hash_table_insert_hash(hashtable, key, value, hash);
+}
+
+
+/**
+ * 删除一个节点.
+ * 
+ * @param hashtable: 散列表
+ * @param key: 删除节点关键值
+ * 
+ * @return 0:删除成功
+ *        -1:哈希表不存在 或 key为空
+ *        -2:节点不存在
+ */
+int hash_table_delete(struct hash_table *hashtable, void *key)
+{
+    struct hash_table_node **bucket = NULL;
+    struct hash_table_node *prev = NULL;
+    struct hash_table_node *cur = NULL;
+    unsigned int hash = 0;
+
+    if (hashtable == NULL || key == NULL)
+        return -1;
+
+    /*根据key计算出哈希值*/
+    hash = hashtable->hashfun(hashtable, key);
+    hash_table_rehash_step(hashtable, HASH_TABLE_REHASH_STEP);
+
+    cur = hash_table_find(hashtable, key, hash, &bucket, &prev);
+    if (cur == NULL)
+        return -2;
+
+    if (prev == NULL)/*如果删除的是头结点*/
+    {
+        *bucket = cur->next;
+    }
+    else
+    {
+        prev->next = cur->next;
+    }
+    /*若节点所指向的数据(包括key和value)为动态分配,则需要在这里释放*/
+    hashtable->valuefree(cur);
+    hash_table_node_free(hashtable, cur);
+
+    hashtable->num --;
+    hash_table_resize_check(hashtable);
+
+    return 0;
+}
+
+/**
+ * 修改一个节点.注意事项:
+ * 1、会先释放节点指向的就数据空间(这里如果是realloc更大的数据空间,容易造成指针泄露,且是不知道整个数据结构的大小的) 
+ * 2、修改的节点必须为新动态分配的空间
+ *
+ * @param hashtable: 散列表
+ * @param key: 修改节点关键值
+ * @param value: 修改节点数据
+ * 
+ * @return 0:修改成功
+ *        -1:哈希表不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ */
+int hash_table_modify(struct hash_table *hashtable, void *key, void *value)
+{
+    struct hash_table_node **bucket = NULL;
+    struct hash_table_node *prev = NULL;
+    struct hash_table_node *cur = NULL;
+    unsigned int hash = 0;
+
+    if (hashtable == NULL || key == NULL || value == NULL)
+        return -1;
+
+    /*根据key计算出哈希值*/
+    hash = hashtable->hashfun(hashtable, key);
+    hash_table_rehash_step(hashtable, HASH_TABLE_REHASH_STEP);
+
+    cur = hash_table_find(hashtable, key, hash, &bucket, &prev);
+    if (cur == NULL)
+        return -2;
+
+    hashtable->valuefree(cur);
+    cur->key = key;
+    cur->value = value;
+
+    return 0;
+}
+
+/**
+ * 根据key查找节点数据.
+ * 
+ * @param hashtable: 散列表
+ * @param key: 查找节点关键值
+ * 
+ * @return NULL:查找失败
+ *        !NULL:查找成功
+ */
+void * hash_table_search(struct hash_table *hashtable, void *key)
+{
+    struct hash_table_node **bucket = NULL;
+    struct hash_table_node *prev = NULL;
+    struct hash_table_node *cur = NULL;
+    unsigned int hash = 0;
+
+    if (hashtable == NULL || key == NULL)
+        return NULL;
+
+    /*根据key计算出哈希值*/
+    hash = hashtable->hashfun(hashtable, key);
+    hash_table_rehash_step(hashtable, HASH_TABLE_REHASH_STEP);
+
+    cur = hash_table_find(hashtable, key, hash, &bucket, &prev);
+    if (cur == NULL)
+        return NULL;
+
+    return cur->value;
+}
+
+/**
+ * 批量操作的预处理:计算一组key的哈希值,并预取这些key所在的哈希桶和桶的头节点.
+ * 先把所有访存请求发出去,后面逐个查找时这些数据已经(或正在)加载到cache中,多个key的访存延迟可以重叠.
+ * key为NULL时跳过,对应的hashs[i]不计算,调用者不能使用.
+ */
+static void hash_table_batch_prefetch(struct hash_table *hashtable, void **keys, unsigned int *hashs, int num)
+{
+    struct hash_table_node *head = NULL;
+    int i = 0;
+
+    for (i = 0; i < num; i++)
+    {
+        if (keys[i] == NULL)
+            continue;
+
+        hashs[i] = hashtable->hashfun(hashtable, keys[i]);
+        HASH_TABLE_PREFETCH(&hashtable->tables[hashs[i] & (hashtable->size - 1)]);
+        if (HASH_TABLE_IS_REHASHING(hashtable))
+        {
+            HASH_TABLE_PREFETCH(&hashtable->rehash_tables[hashs[i] & (hashtable->rehash_size - 1)]);
+        }
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        if (keys[i] == NULL)
+            continue;
+
+        head = hashtable->tables[hashs[i] & (hashtable->size - 1)];
+        if (head != NULL)
+        {
+            HASH_TABLE_PREFETCH(head);
+        }
+        if (HASH_TABLE_IS_REHASHING(hashtable))
+        {
+            head = hashtable->rehash_tables[hashs[i] & (hashtable->rehash_size - 1)];
+            if (head != NULL)
+            {
+                HASH_TABLE_PREFETCH(head);
+            }
+        }
+    }
+}
+
+/**
+ * 批量查找.每HASH_TABLE_BATCH_SIZE个key为一组,先计算哈希值并预取哈希桶,再逐个查找.
+ * 
+ * @param hashtable: 散列表
+ * @param keys: 查找节点关键值数组
+ * @param values: 返回查找到的节点数据,key不存在或为NULL时为NULL
+ * @param num: key的个数
  * 
- * @return 哈希值
+ * @return >=0:查找到的节点个数
+ *          -1:哈希表不存在 或 keys为空 或 values为空
  */
-static int hash_fun_default(struct hash_table *table, const void *key)
+int hash_table_search_batch(struct hash_table *hashtable, void **keys, void **values, int num)
 {
-    unsigned int hash = 0;
-    unsigned int seed = 131;
-	char *temp = NULL;
-	
-	temp = (char*)key;
-    while(*temp)
+    unsigned int hashs[HASH_TABLE_BATCH_SIZE];
+    struct hash_table_node **bucket = NULL;
+    struct hash_table_node *prev = NULL;
+    struct hash_table_node *cur = NULL;
+    int i = 0, n = 0, found = 0;
+
+    if (hashtable == NULL || keys == NULL || values == NULL)
+        return -1;
+
+    while (num > 0)
     {
-        hash = hash * seed + *temp++;
+        n = (num > HASH_TABLE_BATCH_SIZE) ? HASH_TABLE_BATCH_SIZE : num;
+
+        /*迁移会替换哈希桶,要在预取之前做*/
+        hash_table_rehash_step(hashtable, HASH_TABLE_REHASH_STEP * n);
+        hash_table_batch_prefetch(hashtable, keys, hashs, n);
+
+        for (i = 0; i < n; i++)
+        {
+            if (keys[i] == NULL)
+            {
+                values[i] = NULL;
+                continue;
+            }
+
+            cur = hash_table_find(hashtable, keys[i], hashs[i], &bucket, &prev);
+            values[i] = (cur != NULL) ? cur->value : NULL;
+            if (cur != NULL)
+                found++;
+        }
+
+        keys   += n;
+        values += n;
+        num    -= n;
     }
-    
-    hash &= 0x7FFFFFFF;
-    hash %= table->size;
 
-    return hash;
+    return found;
 }
 
 /**
- * 哈希key比较, key_cmp:传入的要比较的key, key_becmp:哈希表中被比较的key
+ * 批量插入.每HASH_TABLE_BATCH_SIZE个key为一组,先计算哈希值并预取哈希桶,再逐个插入.
  * 
- * @return > 0 : key_cmp > key_becmp
- * @return = 0 : key_cmp = key_becmp
- * @return < 0 : key_cmp < key_becmp
+ * @param hashtable: 散列表
+ * @param keys: 关键值数组
+ * @param values: 节点数据数组
+ * @param num: key的个数
+ * @param results: 返回每个节点的插入结果(同hash_table_insert),不需要时可以为NULL
  * 
+ * @return >=0:插入成功的节点个数
+ *          -1:哈希表不存在 或 keys为空 或 values为空
+ */
+int hash_table_insert_batch(struct hash_table *hashtable, void **keys, void **values, int num, int *results)
+{
+    unsigned int hashs[HASH_TABLE_BATCH_SIZE];
+    int i = 0, n = 0, res = 0, inserted = 0;
+
+    if (hashtable == NULL || keys == NULL || values == NULL)
+        return -1;
+
+    while (num > 0)
+    {
+        n = (num > HASH_TABLE_BATCH_SIZE) ? HASH_TABLE_BATCH_SIZE : num;
+
+        hash_table_rehash_step(hashtable, HASH_TABLE_REHASH_STEP * n);
+        hash_table_batch_prefetch(hashtable, keys, hashs, n);
+
+        for (i = 0; i < n; i++)
+        {
+            if (keys[i] == NULL || values[i] == NULL)
+                res = -1;
+            else
+                res = hash_table_insert_hash(hashtable, keys[i], values[i], hashs[i]);
+
+            if (res == 0)
+                inserted++;
+            if (results != NULL)
+                results[i] = res;
+        }
+
+        keys   += n;
+        values += n;
+        num    -= n;
+        if (results != NULL)
+            results += n;
+    }
+
+    return inserted;
+}
+
+/**
+ * 释放所有节点(包括迁移中的新哈希桶),对每个节点调用valuefree,使用节点池时按块整体释放节点.
+ * 释放后哈希桶中的节点指针没有清空,由调用者处理.
  */
-static int hash_keycmp_default(struct hash_table *table, const void *key_cmp, const void *key_becmp)
+static void hash_table_nodes_free(struct hash_table *hashtable)
 {
-    return strcmp(key_cmp, key_becmp);
+    struct hash_table_node **tables[2];
+    struct hash_table_node *cur = NULL;
+    struct hash_table_node *next = NULL;
+    struct hash_table_chunk *chunk = NULL;
+    int sizes[2];
+    int i = 0, j = 0;
+
+    tables[0] = hashtable->tables;
+    sizes[0]  = hashtable->size;
+    tables[1] = hashtable->rehash_tables;
+    sizes[1]  = hashtable->rehash_size;
+
+    for (j = 0; j < 2; j++)
+    {
+        if (tables[j] == NULL)
+            continue;
+
+        for (i = 0; i < sizes[j]; i++)
+        {
+            for (cur = tables[j][i]; cur != NULL; cur = next)
+            {
+                next = cur->next;
+                if (hashtable->valuefree != NULL)
+                    hashtable->valuefree(cur);
+                if (hashtable->pool_chunk_num == 0)
+                {
+                    HASH_TABLE_FREE(cur);
+                }
+            }
+        }
+    }
+
+    while ((chunk = hashtable->pool_chunks) != NULL)
+    {
+        hashtable->pool_chunks = chunk->next;
+        HASH_TABLE_FREE(chunk);
+    }
+    hashtable->pool_free = NULL;
+    hashtable->num = 0;
 }
 
 /**
- * 动态创建一个哈希表.
+ * 清空哈希表.一次遍历释放所有节点,正在进行的迁移直接结束,保留当前(较大的)哈希桶.
  * 
- * @return NULL:创建失败
- *        !NULL:创建成功
+ * @param hashtable: 散列表
+ * 
+ * @return 0:清空成功
+ *        -1:哈希表不存在
  */
-struct hash_table *hash_table_creat(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree)
+int hash_table_clear(struct hash_table *hashtable)
 {
-    struct hash_table *hashtable = NULL;
-    struct hash_table_node **tables = NULL;
     int i = 0;
 
-    if (size < 0 || hashfun == NULL || keycmp == NULL)
-        return NULL;
-
-    /*申请哈希表结构空间*/
-    hashtable = HASH_TABLE_MALLOC(sizeof(*hashtable));
     if (hashtable == NULL)
-        return NULL;
-    
-    /*申请哈希桶数据空间,实际就是申请size大小的数组空间*/
-    tables = (struct hash_table_node**)HASH_TABLE_MALLOC(size * sizeof(tables));
-    if (tables == NULL)
-        return NULL;
+        return -1;
 
-    hashtable->num       = 0;
-    hashtable->size      = size;
-    hashtable->tables    = tables;
-    hashtable->hashfun   = hashfun;
-    hashtable->keycmp    = keycmp;
-    hashtable->valuefree = valuefree;
+    hash_table_nodes_free(hashtable);
 
-    /*清零哈希桶(数组)空间*/
-    for (i = 0; i < size; i++)
+    if (HASH_TABLE_IS_REHASHING(hashtable))
+    {
+        HASH_TABLE_FREE(hashtable->tables);
+        hashtable->tables        = hashtable->rehash_tables;
+        hashtable->size          = hashtable->rehash_size;
+        hashtable->rehash_tables = NULL;
+        hashtable->rehash_size   = 0;
+        hashtable->rehash_idx    = -1;
+    }
+
+    for (i = 0; i < hashtable->size; i++)
     {
         hashtable->tables[i] = NULL;
     }
-    
-    return hashtable;
+
+    return 0;
 }
 
 /**
- * 使用默认的函数函数、key比较函数、节点删除函数 动态创建一个哈希表.
+ * 销毁哈希表.对每个节点调用valuefree,使用节点池时按块整体释放节点.
  * 
- * @return NULL:创建失败
- *        !NULL:创建成功
+ * @param hashtable: 散列表
  */
-struct hash_table *hash_table_creat_default(int size, node_value_free valuefree)
+void hash_table_destroy(struct hash_table **hashtable)
 {
-    return hash_table_creat(size, hash_fun_default, hash_keycmp_default, valuefree);
-}
+    if (hashtable == NULL || *hashtable == NULL)
+        return;
+
+    hash_table_nodes_free(*hashtable);
+    HASH_TABLE_FREE((*hashtable)->tables);
+    if ((*hashtable)->rehash_tables != NULL)
+    {
+        HASH_TABLE_FREE((*hashtable)->rehash_tables);
+    }
 
+    HASH_TABLE_FREE(*hashtable);
+    *hashtable = NULL;
+}
 
 /**
- * 向一个哈希桶插入一个节点,有3种情况:
- * 1、prev==NULL,插入位置是头结点 2、key小于cur->key 3、cur==NULL,链表尾插入
- * 
- * @param hashtable: 散列表
- * @param key: 关键值
- * @param value: 节点数据
- * @param value: 节点数据大小
- * 
- * @return 0:插入成功
- *        -1:哈希表不存在 或 key为空 或 value为空
- *        -2:节点已经存在
+ * 二进制位反转.
  */
-int hash_table_insert(struct hash_table *hashtable, void *key, void *value)
+static unsigned int hash_table_rev(unsigned int v)
 {
-    struct hash_table_node *prev = NULL;
-    struct hash_table_node *cur = NULL;
-    struct hash_table_node *new_node = NULL;
-    int hvalue = 0;
+    unsigned int s = 8 * sizeof(v);
+    unsigned int mask = ~0u;
 
-    if (hashtable == NULL || key == NULL || value == NULL)
-        return -1;
+    while ((s >>= 1) > 0)
+    {
+        mask ^= (mask << s);
+        v = ((v >> s) & mask) | ((v << s) & ~mask);
+    }
 
-    /*根据key计算出哈希值*/
-    hvalue = hashtable->hashfun(hashtable, key);
-    cur = hashtable->tables[hvalue];
+    return v;
+}
+
+/**
+ * 遍历一个哈希桶,对每个节点调用fun.
+ */
+static void hash_table_scan_bucket(struct hash_table *hashtable, struct hash_table_node *cur, hash_table_scan_fun fun, void *param)
+{
+    struct hash_table_node *next = NULL;
 
-    /*hash桶中的元素是从小到大排列的,查找要插入的位置*/
-    while((cur != NULL) && (hashtable->keycmp(hashtable, key, cur->key) > 0))
+    while (cur != NULL)
     {
-        prev = cur;
-        cur = cur->next;
+        next = cur->next;
+        fun(hashtable, cur, param);
+        cur = next;
     }
+}
 
-    /*如果key相同,表示节点以及存在,直接返回*/
-    if ((cur != NULL) && (hashtable->keycmp(hashtable, key, cur->key) == 0))
-        return -2;
+/**
+ * 基于游标的遍历(同Redis SCAN).每次调用遍历一个哈希桶(迁移中时为旧桶及其在新桶中对应的所有桶),返回下一次的游标.
+ * 游标按高位加1的顺序递增,哈希桶大小都是2的幂,扩容/缩容后已经遍历过的桶对应的新桶也都在游标之前,
+ * 所以两次调用之间可以插入/删除/发生迁移:遍历开始到结束一直存在的节点一定会被遍历到,但可能被遍历多次.
+ * fun中不能插入/删除节点.
+ * 
+ * @param hashtable: 散列表
+ * @param cursor: 游标,第一次调用时为0
+ * @param fun: 节点处理函数
+ * @param param: 传给fun的参数
+ * 
+ * @return 下一次调用的游标, 0:遍历结束
+ */
+unsigned int hash_table_scan(struct hash_table *hashtable, unsigned int cursor, hash_table_scan_fun fun, void *param)
+{
+    struct hash_table_node **t0 = NULL, **t1 = NULL;
+    unsigned int m0 = 0, m1 = 0;
 
-    /*插入新增节点*/
-    new_node = (struct hash_table_node*)HASH_TABLE_MALLOC(sizeof(*new_node));
-    if (new_node == NULL)
-        return NULL;
+    if (hashtable == NULL || fun == NULL || hashtable->num == 0)
+        return 0;
 
-    new_node->key = key;
-    new_node->value = value;
-    if (prev == NULL) /*第1种情况*/
+    if (!HASH_TABLE_IS_REHASHING(hashtable))
     {
-        new_node->next = NULL;
-		hashtable->tables[hvalue] = new_node;/*这里不能为cur = new_node,因为此时的cur和table[hvalue]都是无效的*/
+        m0 = hashtable->size - 1;
+        hash_table_scan_bucket(hashtable, hashtable->tables[cursor & m0], fun, param);
+
+        cursor |= ~m0;
+        cursor = hash_table_rev(cursor);
+        cursor++;
+        cursor = hash_table_rev(cursor);
+        return cursor;
     }
-    else /*第2、3种情况*/
+
+    /*t0为较小的哈希桶, t1为较大的哈希桶*/
+    t0 = hashtable->tables;
+    m0 = hashtable->size - 1;
+    t1 = hashtable->rehash_tables;
+    m1 = hashtable->rehash_size - 1;
+    if (m0 > m1)
     {
-        new_node->next = cur;
-        prev->next = new_node;
+        t0 = hashtable->rehash_tables;
+        m0 = hashtable->rehash_size - 1;
+        t1 = hashtable->tables;
+        m1 = hashtable->size - 1;
     }
-    
-    hashtable->num ++;
 
-    return 0;
-}
+    hash_table_scan_bucket(hashtable, t0[cursor & m0], fun, param);
 
+    /*遍历较小哈希桶中cursor对应的桶扩展到较大哈希桶中的所有桶*/
+    do
+    {
+        hash_table_scan_bucket(hashtable, t1[cursor & m1], fun, param);
+
+        cursor |= ~m1;
+        cursor = hash_table_rev(cursor);
+        cursor++;
+        cursor = hash_table_rev(cursor);
+    } while (cursor & (m0 ^ m1));
+
+    return cursor;
+}
 
 /**
- * 删除一个节点.
+ * 将所有节点的key和value导出到连续的数组中.
  * 
  * @param hashtable: 散列表
- * @param key: 删除节点关键值
+ * @param entries: 导出数组
+ * @param num: 导出数组的大小,一般为hashtable->num
  * 
- * @return 0:删除成功
- *        -1:哈希表不存在 或 key为空
- *        -2:节点不存在
+ * @return >=0:导出的节点个数
+ *          -1:哈希表不存在 或 entries为空
  */
-int hash_table_delete(struct hash_table *hashtable, void *key)
+int hash_table_export(struct hash_table *hashtable, struct hash_table_entry *entries, int num)
 {
-    struct hash_table_node *prev = NULL;
+    struct hash_table_node **tables[2];
     struct hash_table_node *cur = NULL;
-    int hvalue = 0;
+    int sizes[2];
+    int i = 0, j = 0, n = 0;
 
-    if (hashtable == NULL || key == NULL)
+    if (hashtable == NULL || entries == NULL)
         return -1;
 
-    /*根据key计算出哈希值*/
-    hvalue = hashtable->hashfun(hashtable, key);
-    cur = hashtable->tables[hvalue];
+    tables[0] = hashtable->tables;
+    sizes[0]  = hashtable->size;
+    tables[1] = hashtable->rehash_tables;
+    sizes[1]  = hashtable->rehash_size;
 
-    /*hash桶中的元素是从小到大排列的,查找要删除的位置*/
-    while((cur != NULL) && (hashtable->keycmp(hashtable, key, cur->key) >= 0))
+    for (j = 0; j < 2; j++)
     {
-        if (hashtable->keycmp(hashtable, key, cur->key) == 0)
+        for (i = 0; (tables[j] != NULL) && (i < sizes[j]); i++)
         {
-            if (prev == NULL)/*如果删除的是头结点*/
-            {
-                hashtable->tables[hvalue] = cur->next;
-            }
-            else
+            for (cur = tables[j][i]; (cur != NULL) && (n < num); cur = cur->next)
             {
-                prev->next = cur->next;
+                entries[n].key = cur->key;
+                entries[n].value = cur->value;
+                n++;
             }
-            /*若节点所指向的数据(包括key和value)为动态分配,则需要在这里释放*/
-            hashtable->valuefree(cur);
-            HASH_TABLE_FREE(cur);
-
-            hashtable->num --;
-            return 0;
-        }
-        else
-        {
-            prev = cur;
-            cur = cur->next;
         }
     }
 
-    return -2;
+    return n;
 }
 
 /**
- * 修改一个节点.注意事项:
- * 1、会先释放节点指向的就数据空间(这里如果是realloc更大的数据空间,容易造成指针泄露,且是不知道整个数据结构的大小的) 
- * 2、修改的节点必须为新动态分配的空间
- *
+ * 统计哈希表状态.哈希桶长度相关的统计需要遍历所有哈希桶,运行计数需要定义HASH_TABLE_USING_STATS.
+ * 负载因子高但最长哈希桶短说明哈希表太小,平均比较次数明显大于 1+负载因子/2 或直方图长尾说明哈希函数分布不均匀.
+ * 
  * @param hashtable: 散列表
- * @param key: 修改节点关键值
- * @param value: 修改节点数据
+ * @param stats: 返回统计信息
  * 
- * @return 0:修改成功
- *        -1:哈希表不存在 或 key为空 或value为空
- *        -2:节点不存在
+ * @return  0:成功
+ *         -1:哈希表不存在 或 stats为空
  */
-int hash_table_modify(struct hash_table *hashtable, void *key, void *value)
+int hash_table_stats_get(struct hash_table *hashtable, struct hash_table_stats *stats)
 {
+    struct hash_table_node **tables[2];
     struct hash_table_node *cur = NULL;
-    int hvalue = 0;
+    int sizes[2];
+    int i = 0, j = 0, len = 0;
 
-    if (hashtable == NULL || key == NULL || value == NULL)
+    if (hashtable == NULL || stats == NULL)
         return -1;
 
-    /*根据key计算出哈希值*/
-    hvalue = hashtable->hashfun(hashtable, key);
-    cur = hashtable->tables[hvalue];
+    memset(stats, 0, sizeof(*stats));
+
+    tables[0] = hashtable->tables;
+    sizes[0]  = hashtable->size;
+    tables[1] = hashtable->rehash_tables;
+    sizes[1]  = hashtable->rehash_size;
 
-    /*hash桶中的元素是从小到大排列的,查找要修改的位置*/
-    while((cur != NULL) && (hashtable->keycmp(hashtable, key, cur->key) >= 0))
+    for (j = 0; j < 2; j++)
     {
-        if (hashtable->keycmp(hashtable, key, cur->key) == 0)
-        {
-			hashtable->valuefree(cur);
-			cur->key = key;
-			cur->value = value;
-            return 0;
-        }
-        else
+        for (i = 0; (tables[j] != NULL) && (i < sizes[j]); i++)
         {
-            cur = cur->next;
+            len = 0;
+            for (cur = tables[j][i]; cur != NULL; cur = cur->next)
+                len++;
+
+            stats->hist[(len < HASH_TABLE_STATS_HIST_NUM) ? len : (HASH_TABLE_STATS_HIST_NUM - 1)]++;
+            if (len > stats->max_chain)
+                stats->max_chain = len;
+            if (len > 0)
+                stats->used++;
         }
+        stats->size += (tables[j] != NULL) ? sizes[j] : 0;
     }
 
-    return -2;
+    stats->num       = hashtable->num;
+    stats->load      = (int)((long)hashtable->num * 100 / stats->size);
+    stats->rehashing = HASH_TABLE_IS_REHASHING(hashtable);
+    if (stats->used > 0)
+        stats->mean_chain = (int)((long)hashtable->num * 100 / stats->used);
+
+#ifdef HASH_TABLE_USING_STATS
+    stats->searches = hashtable->stat_searches;
+    stats->cmps     = hashtable->stat_cmps;
+    stats->grows    = hashtable->stat_grows;
+    stats->shrinks  = hashtable->stat_shrinks;
+    if (stats->searches > 0)
+        stats->avg_cmps = (int)(stats->cmps * 100 / stats->searches);
+#endif
+
+    return 0;
 }
 
 /**
- * 根据key查找节点数据.
- * 
- * @param hashtable: 散列表
- * @param key: 查找节点关键值
- * @param value: 查找节点数据
- * 
- * @return NULL:查找失败
- *        !NULL:查找成功
+ * 清零运行计数.
  */
-void * hash_table_search(struct hash_table *hashtable, void *key)
+void hash_table_stats_reset(struct hash_table *hashtable)
 {
-    struct hash_table_node *cur = NULL;
-    int hvalue = 0;
+    if (hashtable == NULL)
+        return;
 
-    if (hashtable == NULL || key == NULL)
-        return NULL;
+#ifdef HASH_TABLE_USING_STATS
+    hashtable->stat_searches = 0;
+    hashtable->stat_cmps     = 0;
+    hashtable->stat_grows    = 0;
+    hashtable->stat_shrinks  = 0;
+#endif
+}
 
-    /*根据key计算出哈希值*/
-    hvalue = hashtable->hashfun(hashtable, key);
-    cur = hashtable->tables[hvalue];
+/*引擎接口,参数类型为void *的转接函数*/
+static void *hash_table_ops_creat(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree)
+{
+    return hash_table_creat(size, hashfun, keycmp, valuefree);
+}
 
-    /*hash桶中的元素是从小到大排列的,查找要查找的位置*/
-    while((cur != NULL) && (hashtable->keycmp(hashtable, key, cur->key) >= 0))
-    {
-        if (hashtable->keycmp(hashtable, key, cur->key) == 0)
-        {
-            return cur->value;
-        }
-        else
-        {
-            cur = cur->next;
-        }
-    }
+static void *hash_table_ops_creat_default(int size, node_value_free valuefree)
+{
+    return hash_table_creat_default(size, valuefree);
+}
 
-    return NULL;
+static void *hash_table_ops_creat_binary(int size, int keylen, node_value_free valuefree)
+{
+    return hash_table_creat_binary(size, keylen, valuefree);
+}
+
+static int hash_table_ops_insert(void *table, void *key, void *value)
+{
+    return hash_table_insert(table, key, value);
+}
+
+static int hash_table_ops_delete(void *table, void *key)
+{
+    return hash_table_delete(table, key);
+}
+
+static int hash_table_ops_modify(void *table, void *key, void *value)
+{
+    return hash_table_modify(table, key, value);
+}
+
+static void *hash_table_ops_search(void *table, void *key)
+{
+    return hash_table_search(table, key);
 }
 
+static void hash_table_ops_destroy(void *table)
+{
+    struct hash_table *hashtable = table;
+
+    hash_table_destroy(&hashtable);
+}
+
+/*链式哈希表引擎*/
+const struct hash_table_ops hash_table_chain_ops =
+{
+    hash_table_ops_creat,
+    hash_table_ops_creat_default,
+    hash_table_ops_creat_binary,
+    hash_table_ops_insert,
+    hash_table_ops_delete,
+    hash_table_ops_modify,
+    hash_table_ops_search,
+    hash_table_ops_destroy,
+};
+
 
 /*******************************************************************************************
  *                                          使用示例
@@ -380,13 +1385,78 @@ void hash_table_sample(void)
 }
 
 
+/*******************************************************************************************
+ *                                   哈希函数性能对比
+ *******************************************************************************************/
+#define HASH_BENCH_KEY_NUM  256
+#define HASH_BENCH_ROUNDS   100
 
+/*原来使用的BKDR哈希函数,逐字节计算*/
+static unsigned int hash_fun_bkdr(const char *key)
+{
+    unsigned int hash = 0;
+    unsigned int seed = 131;
 
+    while (*key)
+    {
+        hash = hash * seed + *key++;
+    }
 
+    return hash;
+}
 
+/*key长度为8、64、1024字节时,两种哈希函数各计算HASH_BENCH_ROUNDS*HASH_BENCH_KEY_NUM次的耗时(tick),[x][0]:BKDR [x][1]:默认哈希*/
+rt_tick_t hash_bench_ticks[3][2];
+volatile unsigned int hash_bench_sink;
 
+void hash_table_hash_bench(void)
+{
+    static const int lens[3] = {8, 64, 1024};
+    char *keys = NULL, *key = NULL;
+    rt_tick_t start = 0;
+    unsigned int sum = 0, seed = rand();
+    int i = 0, j = 0, r = 0, l = 0, len = 0;
 
+    keys = HASH_TABLE_MALLOC(HASH_BENCH_KEY_NUM * (1024 + 1));
+    if (keys == NULL)
+        return;
 
+    for (l = 0; l < 3; l++)
+    {
+        len = lens[l];
+        for (i = 0; i < HASH_BENCH_KEY_NUM; i++)
+        {
+            key = keys + i * (len + 1);
+            for (j = 0; j < len; j++)
+            {
+                key[j] = 'a' + rand() % 26;
+            }
+            key[len] = 0;
+        }
 
+        start = rt_tick_get();
+        for (r = 0; r < HASH_BENCH_ROUNDS; r++)
+        {
+            for (i = 0; i < HASH_BENCH_KEY_NUM; i++)
+            {
+                sum += hash_fun_bkdr(keys + i * (len + 1));
+            }
+        }
+        hash_bench_ticks[l][0] = rt_tick_get() - start;
 
+        /*与默认哈希函数一样,字符串key需要先计算长度*/
+        start = rt_tick_get();
+        for (r = 0; r < HASH_BENCH_ROUNDS; r++)
+        {
+            for (i = 0; i < HASH_BENCH_KEY_NUM; i++)
+            {
+                key = keys + i * (len + 1);
+                sum += hash_table_hash_bytes(key, strlen(key), seed);
+            }
+        }
+        hash_bench_ticks[l][1] = rt_tick_get() - start;
+    }
 
+    hash_bench_sink = sum;
+    HASH_TABLE_FREE(keys);
+}
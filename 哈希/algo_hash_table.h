@@ -4,6 +4,14 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-12-27     denghengli   the first version
+ * 2026-10-17     denghengli   incremental rehash driven by load factor
+ * 2026-10-17     denghengli   cache the full hash in each node
+ * 2026-10-17     denghengli   seeded word-at-a-time default hash, binary keys, power-of-two buckets
+ * 2026-10-17     denghengli   batched search/insert with software prefetch
+ * 2026-10-17     denghengli   per-table node pool and hash_table_destroy
+ * 2026-10-17     denghengli   cursor scan, clear and bulk export
+ * 2026-10-17     denghengli   chain length and probe statistics (HASH_TABLE_USING_STATS)
+ * 2026-10-17     denghengli   engine ops table shared with hash_open
  */
 
 #ifndef __ALGO_HASH_TABLE_H__
@@ -20,14 +28,42 @@
 #define HASH_TABLE_CALLOC(n,size)  rt_calloc(n,size);
 #define HASH_TABLE_FREE(p)         rt_free(p);
 
+#define HASH_TABLE_LOAD_FACTOR     100 /*默认扩容负载因子(百分比),节点个数达到哈希桶大小时扩容*/
+#define HASH_TABLE_SHRINK_FACTOR   10  /*默认缩容负载因子(百分比)*/
+#define HASH_TABLE_REHASH_STEP     1   /*每次插入/删除/修改/查找时迁移的哈希桶个数*/
+
+#define HASH_TABLE_BATCH_SIZE      16  /*批量操作时每组预取的key个数*/
+#define HASH_TABLE_POOL_CHUNK_NUM  64  /*默认节点池每块包含的节点个数,0表示不使用节点池*/
+
+/*软件预取,编译器不支持时为空操作*/
+#if defined(__GNUC__)
+#define HASH_TABLE_PREFETCH(addr)  __builtin_prefetch(addr)
+#else
+#define HASH_TABLE_PREFETCH(addr)
+#endif
+
+/* 定义后统计查找次数、查找时比较的节点个数和扩容/缩容次数,每次查找只增加两个计数,可以在正式版本中打开 */
+//#define HASH_TABLE_USING_STATS
+
+#define HASH_TABLE_STATS_HIST_NUM  8   /*哈希桶长度直方图的个数,最后一个统计长度不小于HASH_TABLE_STATS_HIST_NUM-1的桶*/
+
+#ifdef HASH_TABLE_USING_STATS
+#define HASH_TABLE_STAT_ADD(field, n)  ((field) += (n))
+#else
+#define HASH_TABLE_STAT_ADD(field, n)  ((void)0)
+#endif
+
+/*生成每个哈希表哈希种子的随机源,有硬件随机数发生器时建议替换*/
+#define HASH_TABLE_RANDOM_SEED()   rt_tick_get()
+
 struct hash_table_node;
 struct hash_table;
 
-/* 哈希函数,根据key计算哈希值 */
-typedef int (*hash_fun)(struct hash_table *table, const void *key);
+/* 哈希函数,根据key计算哈希值,返回完整的32位哈希值,由哈希表根据哈希桶大小取模 */
+typedef unsigned int (*hash_fun)(struct hash_table *table, const void *key);
 /* 
  *哈希key比较, key_cmp:传入的要比较的key, key_becmp:哈希表中被比较的key
- * hash桶中的元素是从小到大排列的，
+ * hash桶中的元素先按哈希值、哈希值相等时再按key从小到大排列的，
  * 返回值 > 0 : key_cmp > key_becmp
  * 返回值 = 0 : key_cmp = key_becmp
  * 返回值 < 0 : key_cmp < key_becmp
@@ -35,24 +71,102 @@ typedef int (*hash_fun)(struct hash_table *table, const void *key);
 typedef int (*hash_keycmp)(struct hash_table *table, const void *key_cmp, const void *key_becmp);
 /* hash桶中的节点数据删除函数,如果插入节点为动态分配,则需要在该函数中释放节点空间 */
 typedef int (*node_value_free)(struct hash_table_node *node);
+/* 遍历哈希表时的节点处理函数 */
+typedef void (*hash_table_scan_fun)(struct hash_table *table, struct hash_table_node *node, void *param);
 
 struct hash_table_node
 {
     void *key;
     void *value;
+    unsigned int hash;            /*key的完整哈希值,比较key和迁移时使用*/
     struct hash_table_node *next; /*哈希桶节点下个节点*/
 };
 
+/*导出哈希表时的节点数据*/
+struct hash_table_entry
+{
+    void *key;
+    void *value;
+};
+
+/*节点池中的一块,一次申请多个节点*/
+struct hash_table_chunk
+{
+    struct hash_table_chunk *next;
+    struct hash_table_node nodes[];
+};
+
+/*
+ * 哈希表引擎接口.链式哈希表(hash_table_chain_ops)和开放寻址哈希表(hash_open_ops)使用相同的
+ * 哈希函数、key比较和节点数据删除回调,调用者保存ops和creat返回的表,更换ops即可切换引擎.
+ */
+struct hash_table_ops
+{
+    void * (*creat)(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree);
+    void * (*creat_default)(int size, node_value_free valuefree);
+    void * (*creat_binary)(int size, int keylen, node_value_free valuefree);
+    int    (*insert)(void *table, void *key, void *value);
+    int    (*delete)(void *table, void *key);
+    int    (*modify)(void *table, void *key, void *value);
+    void * (*search)(void *table, void *key);
+    void   (*destroy)(void *table);
+};
+
 struct hash_table
 {
-    int size; /*哈希桶的大小,即数组的大小*/
+    int size; /*哈希桶的大小,即数组的大小,为2的幂*/
     int num;  /*各个哈希桶中节点个数的总和*/
     hash_fun hashfun; /*哈希函数*/
     hash_keycmp keycmp; /*哈希key比较*/
     node_value_free valuefree; /*哈希桶节点数据删除*/
+    int keylen;        /*key的字节数,0表示key为字符串*/
+    unsigned int seed; /*哈希种子,每个哈希表随机生成*/
     struct hash_table_node **tables; /*哈希桶,其实就是一个数组*/
+
+    /*渐进式扩容/缩容,迁移过程中同时存在新旧两个哈希桶*/
+    int rehash_size; /*新哈希桶的大小*/
+    int rehash_idx;  /*旧哈希桶中下一个要迁移的桶下标,-1表示没有在迁移*/
+    struct hash_table_node **rehash_tables; /*新哈希桶*/
+    int min_size;      /*缩容的下限,即创建时的大小*/
+    int load_factor;   /*扩容负载因子(百分比),0表示不扩容*/
+    int shrink_factor; /*缩容负载因子(百分比),0表示不缩容*/
+
+    /*节点池,删除的节点放回空闲链表,块在销毁哈希表时整体释放*/
+    int pool_chunk_num;                /*每块包含的节点个数,0表示不使用节点池*/
+    struct hash_table_node *pool_free; /*空闲节点链表,用next连接*/
+    struct hash_table_chunk *pool_chunks; /*已申请的块*/
+
+#ifdef HASH_TABLE_USING_STATS
+    /*运行统计,由hash_table_stats_get读取*/
+    unsigned long stat_searches; /*查找key的次数(包括插入/删除/修改时的查找)*/
+    unsigned long stat_cmps;     /*查找时访问的节点个数*/
+    unsigned long stat_grows;    /*扩容次数*/
+    unsigned long stat_shrinks;  /*缩容次数*/
+#endif
+};
+
+/*哈希表统计信息,比例和平均值都放大100倍*/
+struct hash_table_stats
+{
+    int size;        /*哈希桶的大小,迁移中为新旧哈希桶大小之和*/
+    int num;         /*节点个数*/
+    int load;        /*负载因子(百分比)*/
+    int rehashing;   /*是否在迁移中*/
+    int used;        /*非空哈希桶个数*/
+    int max_chain;   /*最长哈希桶的节点个数*/
+    int mean_chain;  /*非空哈希桶的平均节点个数(x100)*/
+    int hist[HASH_TABLE_STATS_HIST_NUM]; /*hist[i]:节点个数为i的哈希桶个数*/
+
+    /*以下只在定义HASH_TABLE_USING_STATS时有效,否则为0*/
+    unsigned long searches; /*查找次数*/
+    unsigned long cmps;     /*查找时访问的节点个数*/
+    int avg_cmps;           /*每次查找平均访问的节点个数(x100)*/
+    unsigned long grows;    /*扩容次数*/
+    unsigned long shrinks;  /*缩容次数*/
 };
 
+#define HASH_TABLE_IS_REHASHING(table) ((table)->rehash_idx != -1)
+
 /*根据当前结构体元素的地址，获取到结构体首地址*/
 //#define OFFSETOF(TYPE,MEMBER) ((unsigned int)&((TYPE *)0)->MEMBER)
 //#define container(ptr,type,member) ({\
@@ -64,12 +178,30 @@ struct hash_table
 
 extern struct hash_table *hash_table_creat(int size, hash_fun hashfun, hash_keycmp keycmp, node_value_free valuefree);
 extern struct hash_table *hash_table_creat_default(int size, node_value_free valuefree);
+extern struct hash_table *hash_table_creat_binary(int size, int keylen, node_value_free valuefree);
+extern unsigned int hash_table_hash_bytes(const void *key, int len, unsigned int seed);
+extern unsigned int hash_table_hash_default(struct hash_table *table, const void *key);
+extern int    hash_table_keycmp_default(struct hash_table *table, const void *key_cmp, const void *key_becmp);
+extern unsigned int hash_table_seed_creat(const void *owner);
+extern int    hash_table_set_load_factor(struct hash_table *hashtable, int load_factor, int shrink_factor);
+extern int    hash_table_set_pool(struct hash_table *hashtable, int chunk_num);
 extern int    hash_table_insert(struct hash_table *hashtable, void *key, void *value);
 extern int    hash_table_delete(struct hash_table *hashtable, void *key);
 extern int    hash_table_modify(struct hash_table *hashtable, void *key, void *value);
 extern void * hash_table_search(struct hash_table *hashtable, void *key);
+extern int    hash_table_search_batch(struct hash_table *hashtable, void **keys, void **values, int num);
+extern int    hash_table_insert_batch(struct hash_table *hashtable, void **keys, void **values, int num, int *results);
+extern int    hash_table_clear(struct hash_table *hashtable);
+extern void   hash_table_destroy(struct hash_table **hashtable);
+extern unsigned int hash_table_scan(struct hash_table *hashtable, unsigned int cursor, hash_table_scan_fun fun, void *param);
+extern int    hash_table_export(struct hash_table *hashtable, struct hash_table_entry *entries, int num);
+extern int    hash_table_stats_get(struct hash_table *hashtable, struct hash_table_stats *stats);
+extern void   hash_table_stats_reset(struct hash_table *hashtable);
+
+extern const struct hash_table_ops hash_table_chain_ops;
 
 extern void hash_table_sample(void);
+extern void hash_table_hash_bench(void);
 
 #endif
 
@@ -0,0 +1,817 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   split-ordered resize without copying, lock-free retire and per-thread reader slots
+ */
+
+#include "algo_hash_table_conc.h"
+
+/**
+ * 默认使用的哈希函数.keylen为0时key为字符串,否则为keylen字节的二进制数据.
+ *
+ * @return 哈希值
+ */
+static unsigned int hash_conc_fun_default(struct hash_table_conc *table, const void *key)
+{
+    int len = table->keylen;
+
+    if (len == 0)
+        len = strlen((const char *)key);
+
+    return hash_table_hash_bytes(key, len, table->seed);
+}
+
+/**
+ * 哈希key比较.
+ *
+ * @return > 0 : key_cmp > key_becmp
+ * @return = 0 : key_cmp = key_becmp
+ * @return < 0 : key_cmp < key_becmp
+ */
+static int hash_conc_keycmp_default(struct hash_table_conc *table, const void *key_cmp, const void *key_becmp)
+{
+    if (table->keylen == 0)
+        return strcmp(key_cmp, key_becmp);
+
+    return memcmp(key_cmp, key_becmp, table->keylen);
+}
+
+/**
+ * 申请size大小的哈希桶,并清零.
+ *
+ * @return NULL:申请失败
+ *        !NULL:申请成功
+ */
+static struct hash_conc_buckets *hash_conc_buckets_creat(int size)
+{
+    struct hash_conc_buckets *buckets = NULL;
+
+    buckets = (struct hash_conc_buckets *)HASH_CONC_MALLOC(sizeof(*buckets) + size * sizeof(buckets->tables[0]));
+    if (buckets == NULL)
+        return NULL;
+
+    memset(buckets->tables, 0, size * sizeof(buckets->tables[0]));
+    buckets->size = size;
+    buckets->retire_next = NULL;
+
+    return buckets;
+}
+
+/**
+ * 32位按位反转.
+ */
+static unsigned int hash_conc_reverse(unsigned int x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+
+    return (x >> 16) | (x << 16);
+}
+
+/**
+ * 普通节点的分裂序键.哈希值按位反转后,哈希桶序号的各位在高位,同一哈希桶的节点相邻;
+ * 最低位置1,排在同一哈希桶的哨兵节点之后.哈希值的最高位不参与排序,哈希桶大小不能超过2^31.
+ */
+static unsigned int hash_conc_so_key(unsigned int hash)
+{
+    return hash_conc_reverse(hash) | 1;
+}
+
+/**
+ * 申请num个哨兵节点,第i个哨兵节点对应哈希桶first+i,分裂序键为哈希桶序号按位反转.
+ *
+ * @return NULL:申请失败
+ *        !NULL:申请成功
+ */
+static struct hash_conc_node *hash_conc_dummies_creat(int first, int num)
+{
+    struct hash_conc_node *dummies = NULL;
+    int i = 0;
+
+    dummies = (struct hash_conc_node *)HASH_CONC_MALLOC(num * sizeof(*dummies));
+    if (dummies == NULL)
+        return NULL;
+
+    memset(dummies, 0, num * sizeof(*dummies));
+    for (i = 0; i < num; i++)
+    {
+        dummies[i].hash = hash_conc_reverse(first + i);
+    }
+
+    return dummies;
+}
+
+/**
+ * 动态创建一个并发哈希表.
+ *
+ * @param size: 哈希桶的初始大小,会向上取整为2的幂且不小于条带锁个数
+ * @param lock_num: 条带锁个数,会向上取整为2的幂, 0:使用默认值HASH_CONC_LOCK_NUM
+ *
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct hash_table_conc *hash_table_conc_creat(int size, int lock_num, hash_conc_fun hashfun, hash_conc_keycmp keycmp, hash_conc_value_free valuefree)
+{
+    struct hash_table_conc *table = NULL;
+    int i = 0, pow2 = 1;
+
+    if (size <= 0 || lock_num < 0 || hashfun == NULL || keycmp == NULL)
+        return NULL;
+
+    if (lock_num == 0)
+        lock_num = HASH_CONC_LOCK_NUM;
+    while (pow2 < lock_num)
+    {
+        pow2 <<= 1;
+    }
+    lock_num = pow2;
+    while (pow2 < size)
+    {
+        pow2 <<= 1;
+    }
+    size = pow2;
+
+    table = HASH_CONC_MALLOC(sizeof(*table));
+    if (table == NULL)
+        return NULL;
+    memset(table, 0, sizeof(*table));
+
+    table->hashfun   = hashfun;
+    table->keycmp    = keycmp;
+    table->valuefree = valuefree;
+    table->seed      = hash_table_hash_bytes(&table, sizeof(table), HASH_TABLE_RANDOM_SEED());
+    table->lock_num  = lock_num;
+
+    table->buckets = hash_conc_buckets_creat(size);
+    table->dummies = hash_conc_dummies_creat(0, size);
+    table->locks = (rt_mutex_t *)HASH_CONC_MALLOC(lock_num * sizeof(rt_mutex_t));
+    table->reclaim_lock = rt_mutex_create("hconc", RT_IPC_FLAG_PRIO);
+    if (table->buckets == NULL || table->dummies == NULL || table->locks == NULL || table->reclaim_lock == NULL)
+        goto _fail;
+
+    /*初始的各哈希桶是互不相连的链表,以各自的哨兵节点开头*/
+    for (i = 0; i < size; i++)
+    {
+        table->buckets->tables[i] = &table->dummies[i];
+    }
+
+    for (i = 0; i < lock_num; i++)
+    {
+        table->locks[i] = rt_mutex_create("hconc", RT_IPC_FLAG_PRIO);
+        if (table->locks[i] == NULL)
+            goto _fail;
+    }
+
+    return table;
+
+_fail:
+    if (table->locks != NULL)
+    {
+        while (--i >= 0)
+        {
+            rt_mutex_delete(table->locks[i]);
+        }
+        HASH_CONC_FREE(table->locks);
+    }
+    if (table->reclaim_lock != NULL)
+        rt_mutex_delete(table->reclaim_lock);
+    if (table->buckets != NULL)
+    {
+        HASH_CONC_FREE(table->buckets);
+    }
+    if (table->dummies != NULL)
+    {
+        HASH_CONC_FREE(table->dummies);
+    }
+    HASH_CONC_FREE(table);
+    return NULL;
+}
+
+/**
+ * 使用默认的哈希函数、key比较函数 动态创建一个key为字符串的并发哈希表.
+ */
+struct hash_table_conc *hash_table_conc_creat_default(int size, hash_conc_value_free valuefree)
+{
+    return hash_table_conc_creat(size, 0, hash_conc_fun_default, hash_conc_keycmp_default, valuefree);
+}
+
+/**
+ * 使用默认的哈希函数、key比较函数 动态创建一个key为keylen字节二进制数据的并发哈希表.
+ */
+struct hash_table_conc *hash_table_conc_creat_binary(int size, int keylen, hash_conc_value_free valuefree)
+{
+    struct hash_table_conc *table = NULL;
+
+    if (keylen <= 0)
+        return NULL;
+
+    table = hash_table_conc_creat(size, 0, hash_conc_fun_default, hash_conc_keycmp_default, valuefree);
+    if (table != NULL)
+        table->keylen = keylen;
+
+    return table;
+}
+
+/**
+ * 当前线程使用的读者计数槽,按线程控制块地址分散,不同线程大多落在不同的槽中.
+ */
+static int hash_conc_reader_slot(void)
+{
+    unsigned int id = (unsigned int)((unsigned long)rt_thread_self() >> 4);
+
+    return ((id * 0x9E3779B9u) >> 16) & (HASH_CONC_READER_NUM - 1);
+}
+
+/**
+ * 进入读者区间.先登记到当前纪元的读者计数中,登记后纪元已经改变则重新登记,
+ * 保证回收线程要么看到本读者的计数,要么本读者看到新的纪元(此时被回收的节点已经不可达).
+ * 读者计数按线程分散在多个槽中,读者之间不会竞争同一个缓存行.
+ *
+ * @return 读者所在的计数槽和纪元,退出时传给hash_table_conc_read_unlock
+ */
+int hash_table_conc_read_lock(struct hash_table_conc *table)
+{
+    int slot = hash_conc_reader_slot();
+    struct hash_conc_reader *reader = &table->readers[slot];
+    unsigned int epoch = 0;
+
+    while (1)
+    {
+        epoch = HASH_CONC_LOAD_SC(&table->epoch);
+        HASH_CONC_ADD(&reader->count[epoch & 1], 1);
+        if (HASH_CONC_LOAD_SC(&table->epoch) == epoch)
+            return (slot << 1) | (epoch & 1);
+        HASH_CONC_ADD(&reader->count[epoch & 1], -1);
+    }
+}
+
+/**
+ * 退出读者区间.
+ */
+void hash_table_conc_read_unlock(struct hash_table_conc *table, int idx)
+{
+    HASH_CONC_ADD(&table->readers[idx >> 1].count[idx & 1], -1);
+}
+
+/**
+ * 释放待回收的节点和哈希桶.
+ */
+static void hash_conc_free_retired(struct hash_table_conc *table, struct hash_conc_node *node, struct hash_conc_buckets *buckets)
+{
+    struct hash_conc_node *next_node = NULL;
+    struct hash_conc_buckets *next_buckets = NULL;
+
+    while (node != NULL)
+    {
+        next_node = node->retire_next;
+        if (table->valuefree != NULL)
+            table->valuefree(node);
+        HASH_CONC_FREE(node);
+        node = next_node;
+    }
+
+    while (buckets != NULL)
+    {
+        next_buckets = buckets->retire_next;
+        HASH_CONC_FREE(buckets);
+        buckets = next_buckets;
+    }
+}
+
+/**
+ * 尝试推进纪元.纪元从e推进到e+1的条件是没有纪元e-1的读者,此时纪元e-1内删除的节点已经没有读者可以访问:
+ * 纪元e及以后进入的读者都是在这些节点从链表中删除之后才开始查找的.
+ * 只尝试获取锁,其他线程正在回收或还有旧纪元的读者时直接返回,留到下次删除/修改时再回收,写者不会阻塞.
+ */
+static void hash_conc_reclaim(struct hash_table_conc *table)
+{
+    struct hash_conc_node *nodes = NULL;
+    struct hash_conc_buckets *buckets = NULL;
+    int i = 0, old = 0;
+
+    if (rt_mutex_take(table->reclaim_lock, 0) != RT_EOK)
+        return;
+
+    old = (table->epoch + 1) & 1;
+    /*保证前面从链表中删除节点的写操作先于读取读者计数*/
+    HASH_CONC_FENCE();
+    for (i = 0; i < HASH_CONC_READER_NUM; i++)
+    {
+        if (HASH_CONC_LOAD_SC(&table->readers[i].count[old]) != 0)
+        {
+            rt_mutex_release(table->reclaim_lock);
+            return;
+        }
+    }
+
+    nodes = HASH_CONC_XCHG(&table->retired_nodes[old], NULL);
+    buckets = HASH_CONC_XCHG(&table->retired_buckets[old], NULL);
+    HASH_CONC_ADD(&table->epoch, 1);
+    rt_mutex_release(table->reclaim_lock);
+
+    hash_conc_free_retired(table, nodes, buckets);
+}
+
+/**
+ * 将已经从哈希表中删除的节点或替换下来的哈希桶放入当前纪元的待回收链表,再尝试回收.
+ * 待回收链表无锁插入.调用者仍在读者区间内,当前纪元最多比它登记时的纪元大1,
+ * 两种情况下该链表都要等它退出后才会被回收.
+ */
+static void hash_conc_retire(struct hash_table_conc *table, struct hash_conc_node *node, struct hash_conc_buckets *buckets)
+{
+    struct hash_conc_node *node_head = NULL;
+    struct hash_conc_buckets *buckets_head = NULL;
+    int cur = 0;
+
+    /*保证删除节点的写操作先于读取纪元*/
+    HASH_CONC_FENCE();
+    cur = HASH_CONC_LOAD_SC(&table->epoch) & 1;
+
+    if (node != NULL)
+    {
+        node_head = HASH_CONC_LOAD(&table->retired_nodes[cur]);
+        do
+        {
+            node->retire_next = node_head;
+        } while (!HASH_CONC_CAS(&table->retired_nodes[cur], &node_head, node));
+    }
+    if (buckets != NULL)
+    {
+        buckets_head = HASH_CONC_LOAD(&table->retired_buckets[cur]);
+        do
+        {
+            buckets->retire_next = buckets_head;
+        } while (!HASH_CONC_CAS(&table->retired_buckets[cur], &buckets_head, buckets));
+    }
+
+    hash_conc_reclaim(table);
+}
+
+/**
+ * 在哈希桶中查找key.链表中的节点先按分裂序键、再按key从小到大排列,
+ * 下一个哈希桶的哨兵节点的分裂序键比本哈希桶的节点都大,查找在这里停止.
+ *
+ * @param bucket: 哈希桶哨兵节点的next
+ * @param hash: 分裂序键
+ * @param link: 返回指向key所在节点(或key应插入位置)的指针的地址,即前驱节点的next
+ *
+ * @return NULL:节点不存在
+ *        !NULL:key所在的节点
+ */
+static struct hash_conc_node *hash_conc_bucket_find(struct hash_table_conc *table, struct hash_conc_node **bucket, const void *key,
+                                                    unsigned int hash, struct hash_conc_node ***link)
+{
+    struct hash_conc_node *cur = NULL;
+    int res = 0;
+
+    while ((cur = HASH_CONC_LOAD(bucket)) != NULL)
+    {
+        /*分裂序键相等时两个都是普通节点,哨兵节点不会和key比较*/
+        if (cur->hash != hash)
+            res = (hash > cur->hash) ? 1 : -1;
+        else
+            res = table->keycmp(table, key, cur->key);
+
+        if (res == 0)
+            break;
+        if (res < 0)
+        {
+            cur = NULL;
+            break;
+        }
+        bucket = &cur->next;
+    }
+
+    *link = bucket;
+    return cur;
+}
+
+/**
+ * 扩容为原来的2倍.旧哈希桶i中分到新哈希桶i的节点的分裂序键都比分到i+size的小,
+ * 只需在两段之间插入哈希桶i+size的哨兵节点.每次只持有哨兵节点所在哈希桶的条带锁,
+ * 插入前后链表都是有序的,仍在使用旧哈希桶的读者和写者不受影响.
+ * 替换哈希桶指针后旧哈希桶延迟回收,节点不复制也不移动.需要在读者区间内调用.
+ */
+static void hash_conc_resize(struct hash_table_conc *table)
+{
+    struct hash_conc_buckets *old = NULL, *buckets = NULL;
+    struct hash_conc_node *dummies = NULL;
+    struct hash_conc_node **link = NULL;
+    rt_mutex_t lock = NULL;
+    int i = 0, resizing = 0;
+
+    /*同一时间只有一个线程扩容,其他线程直接返回*/
+    if (!HASH_CONC_CAS(&table->resizing, &resizing, 1))
+        return;
+
+    old = HASH_CONC_LOAD(&table->buckets);
+    if ((long)HASH_CONC_LOAD_SC(&table->num) * 100 < (long)old->size * HASH_CONC_LOAD_FACTOR)
+        goto _done;
+
+    buckets = hash_conc_buckets_creat(old->size * 2);
+    dummies = hash_conc_dummies_creat(old->size, old->size);
+    if (buckets == NULL || dummies == NULL)
+    {
+        if (buckets != NULL)
+        {
+            HASH_CONC_FREE(buckets);
+        }
+        if (dummies != NULL)
+        {
+            HASH_CONC_FREE(dummies);
+        }
+        goto _done;
+    }
+
+    for (i = 0; i < old->size; i++)
+    {
+        lock = table->locks[i & (table->lock_num - 1)];
+        rt_mutex_take(lock, RT_WAITING_FOREVER);
+        hash_conc_bucket_find(table, &old->tables[i]->next, NULL, dummies[i].hash, &link);
+        dummies[i].next = *link;
+        HASH_CONC_STORE(link, &dummies[i]);
+        rt_mutex_release(lock);
+
+        buckets->tables[i] = old->tables[i];
+        buckets->tables[i + old->size] = &dummies[i];
+    }
+
+    dummies[0].retire_next = table->dummies;
+    table->dummies = dummies;
+    HASH_CONC_STORE(&table->buckets, buckets);
+    hash_conc_retire(table, NULL, old);
+
+_done:
+    HASH_CONC_STORE(&table->resizing, 0);
+}
+
+/**
+ * 插入一个节点.
+ *
+ * @return 0:插入成功
+ *        -1:哈希表不存在 或 key为空 或 value为空
+ *        -2:节点已经存在
+ *        -3:节点空间申请失败
+ */
+int hash_table_conc_insert(struct hash_table_conc *table, void *key, void *value)
+{
+    struct hash_conc_buckets *buckets = NULL;
+    struct hash_conc_node **link = NULL;
+    struct hash_conc_node *node = NULL;
+    rt_mutex_t lock = NULL;
+    unsigned int hash = 0;
+    int num = 0, size = 0, idx = 0;
+
+    if (table == NULL || key == NULL || value == NULL)
+        return -1;
+
+    hash = table->hashfun(table, key);
+    lock = table->locks[hash & (table->lock_num - 1)];
+
+    /*在锁外申请节点,缩短持有锁的时间*/
+    node = (struct hash_conc_node *)HASH_CONC_MALLOC(sizeof(*node));
+    if (node == NULL)
+        return -3;
+    node->key = key;
+    node->value = value;
+    node->hash = hash_conc_so_key(hash);
+    node->retire_next = NULL;
+
+    idx = hash_table_conc_read_lock(table);
+    rt_mutex_take(lock, RT_WAITING_FOREVER);
+    /*正在扩容时可能读到旧哈希桶,旧哈希桶的哨兵节点仍在链表中,在读者区间内也不会被释放*/
+    buckets = HASH_CONC_LOAD(&table->buckets);
+    if (hash_conc_bucket_find(table, &buckets->tables[hash & (buckets->size - 1)]->next, key, node->hash, &link) != NULL)
+    {
+        rt_mutex_release(lock);
+        hash_table_conc_read_unlock(table, idx);
+        HASH_CONC_FREE(node);
+        return -2;
+    }
+    node->next = *link;
+    HASH_CONC_STORE(link, node);
+    num = HASH_CONC_ADD(&table->num, 1);
+    size = buckets->size;
+    rt_mutex_release(lock);
+
+    if ((long)num * 100 >= (long)size * HASH_CONC_LOAD_FACTOR)
+        hash_conc_resize(table);
+    hash_table_conc_read_unlock(table, idx);
+
+    return 0;
+}
+
+/**
+ * 删除一个节点.节点先从链表中摘除,等没有读者访问后再调用valuefree并释放.
+ *
+ * @return 0:删除成功
+ *        -1:哈希表不存在 或 key为空
+ *        -2:节点不存在
+ */
+int hash_table_conc_delete(struct hash_table_conc *table, void *key)
+{
+    struct hash_conc_buckets *buckets = NULL;
+    struct hash_conc_node **link = NULL;
+    struct hash_conc_node *cur = NULL;
+    rt_mutex_t lock = NULL;
+    unsigned int hash = 0;
+    int idx = 0;
+
+    if (table == NULL || key == NULL)
+        return -1;
+
+    hash = table->hashfun(table, key);
+    lock = table->locks[hash & (table->lock_num - 1)];
+
+    idx = hash_table_conc_read_lock(table);
+    rt_mutex_take(lock, RT_WAITING_FOREVER);
+    buckets = HASH_CONC_LOAD(&table->buckets);
+    cur = hash_conc_bucket_find(table, &buckets->tables[hash & (buckets->size - 1)]->next, key, hash_conc_so_key(hash), &link);
+    if (cur == NULL)
+    {
+        rt_mutex_release(lock);
+        hash_table_conc_read_unlock(table, idx);
+        return -2;
+    }
+    /*正在访问该节点的读者仍然可以通过cur->next继续向后查找*/
+    HASH_CONC_STORE(link, cur->next);
+    HASH_CONC_ADD(&table->num, -1);
+    rt_mutex_release(lock);
+
+    hash_conc_retire(table, cur, NULL);
+    hash_table_conc_read_unlock(table, idx);
+
+    return 0;
+}
+
+/**
+ * 修改一个节点.读者可能正在读取旧节点,所以不在原节点上修改,而是用新节点替换旧节点,旧节点延迟回收.
+ *
+ * @return 0:修改成功
+ *        -1:哈希表不存在 或 key为空 或value为空
+ *        -2:节点不存在
+ *        -3:节点空间申请失败
+ */
+int hash_table_conc_modify(struct hash_table_conc *table, void *key, void *value)
+{
+    struct hash_conc_buckets *buckets = NULL;
+    struct hash_conc_node **link = NULL;
+    struct hash_conc_node *cur = NULL;
+    struct hash_conc_node *node = NULL;
+    rt_mutex_t lock = NULL;
+    unsigned int hash = 0;
+    int idx = 0;
+
+    if (table == NULL || key == NULL || value == NULL)
+        return -1;
+
+    hash = table->hashfun(table, key);
+    lock = table->locks[hash & (table->lock_num - 1)];
+
+    node = (struct hash_conc_node *)HASH_CONC_MALLOC(sizeof(*node));
+    if (node == NULL)
+        return -3;
+    node->key = key;
+    node->value = value;
+    node->hash = hash_conc_so_key(hash);
+    node->retire_next = NULL;
+
+    idx = hash_table_conc_read_lock(table);
+    rt_mutex_take(lock, RT_WAITING_FOREVER);
+    buckets = HASH_CONC_LOAD(&table->buckets);
+    cur = hash_conc_bucket_find(table, &buckets->tables[hash & (buckets->size - 1)]->next, key, node->hash, &link);
+    if (cur == NULL)
+    {
+        rt_mutex_release(lock);
+        hash_table_conc_read_unlock(table, idx);
+        HASH_CONC_FREE(node);
+        return -2;
+    }
+    node->next = cur->next;
+    HASH_CONC_STORE(link, node);
+    rt_mutex_release(lock);
+
+    hash_conc_retire(table, cur, NULL);
+    hash_table_conc_read_unlock(table, idx);
+
+    return 0;
+}
+
+/**
+ * 根据key查找节点数据,不加锁.
+ *
+ * @return NULL:查找失败
+ *        !NULL:查找成功
+ */
+void * hash_table_conc_search(struct hash_table_conc *table, void *key)
+{
+    struct hash_conc_buckets *buckets = NULL;
+    struct hash_conc_node **link = NULL;
+    struct hash_conc_node *cur = NULL;
+    unsigned int hash = 0;
+    void *value = NULL;
+    int idx = 0;
+
+    if (table == NULL || key == NULL)
+        return NULL;
+
+    hash = table->hashfun(table, key);
+
+    idx = hash_table_conc_read_lock(table);
+    buckets = HASH_CONC_LOAD(&table->buckets);
+    cur = hash_conc_bucket_find(table, &buckets->tables[hash & (buckets->size - 1)]->next, key, hash_conc_so_key(hash), &link);
+    if (cur != NULL)
+        value = cur->value;
+    hash_table_conc_read_unlock(table, idx);
+
+    return value;
+}
+
+/**
+ * 销毁并发哈希表.调用时不能再有其他线程访问该哈希表.
+ */
+void hash_table_conc_destroy(struct hash_table_conc **table)
+{
+    struct hash_conc_buckets *buckets = NULL;
+    struct hash_conc_node *cur = NULL, *next = NULL;
+    int i = 0;
+
+    if (table == NULL || *table == NULL)
+        return;
+
+    /*每个哈希桶的节点在它的哨兵节点和下一个哨兵节点之间*/
+    buckets = (*table)->buckets;
+    for (i = 0; i < buckets->size; i++)
+    {
+        cur = buckets->tables[i]->next;
+        while (cur != NULL && cur->key != NULL)
+        {
+            next = cur->next;
+            if ((*table)->valuefree != NULL)
+                (*table)->valuefree(cur);
+            HASH_CONC_FREE(cur);
+            cur = next;
+        }
+    }
+    HASH_CONC_FREE(buckets);
+
+    for (i = 0; i < 2; i++)
+    {
+        hash_conc_free_retired(*table, (*table)->retired_nodes[i], (*table)->retired_buckets[i]);
+    }
+
+    while ((cur = (*table)->dummies) != NULL)
+    {
+        (*table)->dummies = cur->retire_next;
+        HASH_CONC_FREE(cur);
+    }
+
+    for (i = 0; i < (*table)->lock_num; i++)
+    {
+        rt_mutex_delete((*table)->locks[i]);
+    }
+    HASH_CONC_FREE((*table)->locks);
+    rt_mutex_delete((*table)->reclaim_lock);
+    HASH_CONC_FREE(*table);
+    *table = NULL;
+}
+
+
+/*******************************************************************************************
+ *                                   多线程性能测试
+ *******************************************************************************************/
+#define HASH_CONC_BENCH_KEYS         65536
+#define HASH_CONC_BENCH_OPS          100000  /*每个线程的操作次数,80%查找 10%插入 10%删除*/
+#define HASH_CONC_BENCH_MAX_THREADS  32
+#define HASH_CONC_BENCH_STACK        4096    /*测试线程栈大小,全局锁对比中hash_table的调用链也在测试线程上*/
+
+static unsigned int *conc_bench_keys;
+static int conc_bench_done;
+static struct hash_table_conc *conc_bench_table;
+static struct hash_table *conc_bench_global_table;
+static rt_mutex_t conc_bench_global_lock;
+
+/*相同线程数下完成全部操作的耗时(tick), [0]:hash_table + 全局互斥锁 [1]:hash_table_conc*/
+rt_tick_t hash_conc_bench_ticks[2];
+
+static int conc_bench_value_free(struct hash_table_node *node)
+{
+    return 0;
+}
+
+static void conc_bench_entry(void *param)
+{
+    unsigned int r = (unsigned int)(unsigned long)param * 2654435761u + 1;
+    unsigned int *key = NULL;
+    int i = 0, op = 0;
+
+    for (i = 0; i < HASH_CONC_BENCH_OPS; i++)
+    {
+        r ^= r << 13;
+        r ^= r >> 17;
+        r ^= r << 5;
+        key = &conc_bench_keys[r % HASH_CONC_BENCH_KEYS];
+        op = (r >> 24) % 10;
+
+        if (conc_bench_table != NULL)
+        {
+            if (op < 8)
+                hash_table_conc_search(conc_bench_table, key);
+            else if (op == 8)
+                hash_table_conc_insert(conc_bench_table, key, key);
+            else
+                hash_table_conc_delete(conc_bench_table, key);
+        }
+        else
+        {
+            rt_mutex_take(conc_bench_global_lock, RT_WAITING_FOREVER);
+            if (op < 8)
+                hash_table_search(conc_bench_global_table, key);
+            else if (op == 8)
+                hash_table_insert(conc_bench_global_table, key, key);
+            else
+                hash_table_delete(conc_bench_global_table, key);
+            rt_mutex_release(conc_bench_global_lock);
+        }
+    }
+
+    HASH_CONC_ADD(&conc_bench_done, 1);
+}
+
+static rt_tick_t conc_bench_run(int thread_num)
+{
+    rt_thread_t thread = NULL;
+    rt_tick_t start = 0;
+    int i = 0;
+
+    conc_bench_done = 0;
+    start = rt_tick_get();
+    for (i = 0; i < thread_num; i++)
+    {
+        thread = rt_thread_create("hconc", conc_bench_entry, (void *)(unsigned long)(i + 1), HASH_CONC_BENCH_STACK, 20, 10);
+        if (thread == NULL)
+        {
+            HASH_CONC_ADD(&conc_bench_done, 1);
+            continue;
+        }
+        rt_thread_startup(thread);
+    }
+
+    while (HASH_CONC_LOAD_SC(&conc_bench_done) < thread_num)
+    {
+        rt_thread_mdelay(1);
+    }
+
+    return rt_tick_get() - start;
+}
+
+void hash_table_conc_bench(int thread_num)
+{
+    int i = 0;
+
+    if (thread_num <= 0 || thread_num > HASH_CONC_BENCH_MAX_THREADS)
+        return;
+
+    conc_bench_keys = HASH_CONC_MALLOC(HASH_CONC_BENCH_KEYS * sizeof(unsigned int));
+    if (conc_bench_keys == NULL)
+        return;
+    for (i = 0; i < HASH_CONC_BENCH_KEYS; i++)
+    {
+        conc_bench_keys[i] = i;
+    }
+
+    /*hash_table + 全局互斥锁*/
+    conc_bench_table = NULL;
+    conc_bench_global_table = hash_table_creat_binary(HASH_CONC_BENCH_KEYS, sizeof(unsigned int), conc_bench_value_free);
+    conc_bench_global_lock = rt_mutex_create("hconc", RT_IPC_FLAG_PRIO);
+    if (conc_bench_global_table != NULL && conc_bench_global_lock != NULL)
+    {
+        for (i = 0; i < HASH_CONC_BENCH_KEYS; i += 2)
+        {
+            hash_table_insert(conc_bench_global_table, &conc_bench_keys[i], &conc_bench_keys[i]);
+        }
+        hash_conc_bench_ticks[0] = conc_bench_run(thread_num);
+    }
+    hash_table_destroy(&conc_bench_global_table);
+    if (conc_bench_global_lock != NULL)
+        rt_mutex_delete(conc_bench_global_lock);
+
+    /*hash_table_conc*/
+    conc_bench_table = hash_table_conc_creat_binary(HASH_CONC_BENCH_KEYS, sizeof(unsigned int), NULL);
+    if (conc_bench_table != NULL)
+    {
+        for (i = 0; i < HASH_CONC_BENCH_KEYS; i += 2)
+        {
+            hash_table_conc_insert(conc_bench_table, &conc_bench_keys[i], &conc_bench_keys[i]);
+        }
+        hash_conc_bench_ticks[1] = conc_bench_run(thread_num);
+        hash_table_conc_destroy(&conc_bench_table);
+    }
+
+    HASH_CONC_FREE(conc_bench_keys);
+}
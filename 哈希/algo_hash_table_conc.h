@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   split-ordered resize without copying, lock-free retire and per-thread reader slots
+ */
+
+#ifndef __ALGO_HASH_TABLE_CONC_H__
+#define __ALGO_HASH_TABLE_CONC_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rtthread.h>
+#include "algo_hash_table.h"
+
+#define HASH_CONC_MALLOC(size)    rt_malloc(size);
+#define HASH_CONC_FREE(p)         rt_free(p);
+
+#define HASH_CONC_LOCK_NUM        16  /*默认条带锁个数,为2的幂*/
+#define HASH_CONC_LOAD_FACTOR     100 /*扩容负载因子(百分比)*/
+#define HASH_CONC_READER_NUM      16  /*读者计数槽个数,为2的幂,线程按线程控制块地址分散到各个槽*/
+#define HASH_CONC_CACHE_LINE      64  /*缓存行大小,每个读者计数槽独占一个缓存行*/
+
+/*
+ * 原子操作.读者不加锁,链表指针和哈希桶指针的读写都需要原子操作,
+ * 编译器不支持GCC __atomic内建函数时需要替换为平台提供的实现.
+ */
+#define HASH_CONC_LOAD(p)         __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define HASH_CONC_STORE(p, v)     __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define HASH_CONC_LOAD_SC(p)      __atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define HASH_CONC_ADD(p, v)       __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST)
+#define HASH_CONC_XCHG(p, v)      __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST)
+#define HASH_CONC_CAS(p, o, n)    __atomic_compare_exchange_n(p, o, n, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#define HASH_CONC_FENCE()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+struct hash_conc_node;
+struct hash_table_conc;
+
+/* 哈希函数,返回完整的32位哈希值 */
+typedef unsigned int (*hash_conc_fun)(struct hash_table_conc *table, const void *key);
+/* 哈希key比较,返回值 > 0 : key_cmp > key_becmp, = 0 : 相等, < 0 : key_cmp < key_becmp */
+typedef int (*hash_conc_keycmp)(struct hash_table_conc *table, const void *key_cmp, const void *key_becmp);
+/* 节点数据删除函数,节点被删除或修改后,在没有读者访问时才会调用 */
+typedef int (*hash_conc_value_free)(struct hash_conc_node *node);
+
+/*
+ * key为NULL的节点是哈希桶的哨兵节点,只用于定位,不会被删除.
+ */
+struct hash_conc_node
+{
+    void *key;
+    void *value;
+    unsigned int hash;                   /*分裂序键:哈希值按位反转,普通节点最低位为1,哨兵节点为哈希桶序号按位反转*/
+    struct hash_conc_node *next;         /*链表下个节点,读者无锁读取*/
+    struct hash_conc_node *retire_next;  /*待回收链表;哨兵节点块中第一个节点用来连接所有的哨兵节点块*/
+};
+
+struct hash_conc_buckets
+{
+    int size;                                /*哈希桶的大小,为2的幂*/
+    struct hash_conc_buckets *retire_next;   /*待回收链表*/
+    struct hash_conc_node *tables[];         /*各哈希桶的哨兵节点*/
+};
+
+/*读者计数槽,按缓存行填充,避免不同线程的计数落在同一个缓存行*/
+struct hash_conc_reader
+{
+    int count[2];                        /*纪元为奇数/偶数时进入的读者个数*/
+    char pad[HASH_CONC_CACHE_LINE - 2 * sizeof(int)];
+};
+
+/*
+ * 并发哈希表:
+ * 1、写者(插入/删除/修改)按 哈希值 & (lock_num-1) 使用条带锁,哈希桶大小不小于锁个数,扩容后同一个key仍由同一把锁保护
+ * 2、读者(查找)不加锁,删除/修改的节点先无锁放入待回收链表,等所有可能访问它的读者退出后再释放(基于纪元的回收),
+ *    回收只尝试获取锁,读者计数分散在多个槽中
+ * 3、节点按分裂序键排序(分裂序链表),哈希桶i在扩容后分成i和i+size两段,两段在链表中前后相连,
+ *    扩容只需在两段之间插入新哈希桶的哨兵节点再替换哈希桶指针,节点不复制也不移动,写者和读者都不需要停止
+ */
+struct hash_table_conc
+{
+    struct hash_conc_buckets *buckets; /*当前哈希桶*/
+    int num;                           /*节点个数*/
+    int keylen;                        /*key的字节数,0表示key为字符串*/
+    unsigned int seed;                 /*哈希种子*/
+    hash_conc_fun        hashfun;
+    hash_conc_keycmp     keycmp;
+    hash_conc_value_free valuefree;
+
+    int lock_num;                      /*条带锁个数*/
+    rt_mutex_t *locks;                 /*条带锁*/
+
+    int resizing;                      /*正在扩容,同一时间只有一个线程扩容*/
+    struct hash_conc_node *dummies;    /*所有的哨兵节点块,销毁时释放*/
+
+    /*读者纪元与回收*/
+    unsigned int epoch;                /*当前纪元*/
+    rt_mutex_t reclaim_lock;           /*推进纪元时使用*/
+    struct hash_conc_node    *retired_nodes[2];   /*对应纪元内删除的节点*/
+    struct hash_conc_buckets *retired_buckets[2]; /*对应纪元内替换下来的哈希桶*/
+    struct hash_conc_reader readers[HASH_CONC_READER_NUM];
+};
+
+extern struct hash_table_conc *hash_table_conc_creat(int size, int lock_num, hash_conc_fun hashfun, hash_conc_keycmp keycmp, hash_conc_value_free valuefree);
+extern struct hash_table_conc *hash_table_conc_creat_default(int size, hash_conc_value_free valuefree);
+extern struct hash_table_conc *hash_table_conc_creat_binary(int size, int keylen, hash_conc_value_free valuefree);
+extern int    hash_table_conc_insert(struct hash_table_conc *table, void *key, void *value);
+extern int    hash_table_conc_delete(struct hash_table_conc *table, void *key);
+extern int    hash_table_conc_modify(struct hash_table_conc *table, void *key, void *value);
+extern void * hash_table_conc_search(struct hash_table_conc *table, void *key);
+extern void   hash_table_conc_destroy(struct hash_table_conc **table);
+
+/*
+ * 读者区间.hash_table_conc_search返回后节点数据可能被其他线程删除并释放,
+ * 如果需要在删除/修改的同时继续使用查找到的数据,要在read_lock和read_unlock之间查找并使用.
+ * read_lock的返回值包含计数槽和纪元,要原样传给read_unlock.
+ */
+extern int    hash_table_conc_read_lock(struct hash_table_conc *table);
+extern void   hash_table_conc_read_unlock(struct hash_table_conc *table, int idx);
+
+extern void hash_table_conc_bench(int thread_num);
+
+#endif
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   validate bucket offsets and every entry in hash_table_image_open
+ * 2026-10-17     denghengli   check entries lazily in search, map returns a handle with the mapped length
+ *
+ * 哈希表镜像:把哈希表导出为一块只包含相对偏移的连续内存,保存到文件或烧录到flash后,
+ * 映射到内存即可直接查找,不需要逐个节点重新插入,适合启动时加载的大型只读字典.
+ */
+#include "algo_hash_table_image.h"
+
+#ifdef HASH_TABLE_USING_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define HASH_TABLE_IMAGE_BUCKETS(image) ((const unsigned int *)((const char *)(image) + (image)->buckets))
+
+/**
+ * 返回节点key的字节数.
+ */
+static int hash_table_image_keylen(int keylen, const void *key)
+{
+    return keylen > 0 ? keylen : (int)strlen(key);
+}
+
+/**
+ * 镜像哈希桶个数,为不小于节点个数的2的幂.
+ */
+static unsigned int hash_table_image_buckets(int num)
+{
+    unsigned int size = 1;
+
+    while (size < (unsigned int)num)
+        size <<= 1;
+
+    return size;
+}
+
+/**
+ * 节点在镜像中占用的字节数.
+ */
+static unsigned int hash_table_image_entry_size(int keylen, int valuelen)
+{
+    return sizeof(struct hash_table_image_entry) + HASH_TABLE_IMAGE_ALIGN(keylen) + HASH_TABLE_IMAGE_ALIGN(valuelen);
+}
+
+/**
+ * 计算导出镜像需要的字节数.
+ *
+ * @param hashtable: 散列表
+ * @param valuesize: 返回节点value字节数的函数
+ *
+ * @return >0:镜像字节数
+ *         -1:哈希表不存在 或 valuesize为空
+ */
+int hash_table_image_size(struct hash_table *hashtable, hash_table_value_size valuesize)
+{
+    struct hash_table_node **tables[2];
+    struct hash_table_node *cur = NULL;
+    int sizes[2];
+    int i = 0, j = 0;
+    unsigned int total = 0;
+
+    if (hashtable == NULL || valuesize == NULL)
+        return -1;
+
+    tables[0] = hashtable->tables;
+    sizes[0]  = hashtable->size;
+    tables[1] = hashtable->rehash_tables;
+    sizes[1]  = hashtable->rehash_size;
+
+    total = HASH_TABLE_IMAGE_ALIGN(sizeof(struct hash_table_image));
+    total += HASH_TABLE_IMAGE_ALIGN((hash_table_image_buckets(hashtable->num) + 1) * sizeof(unsigned int));
+    for (j = 0; j < 2; j++)
+    {
+        for (i = 0; (tables[j] != NULL) && (i < sizes[j]); i++)
+        {
+            for (cur = tables[j][i]; cur != NULL; cur = cur->next)
+            {
+                total += hash_table_image_entry_size(hash_table_image_keylen(hashtable->keylen, cur->key), valuesize(hashtable, cur));
+            }
+        }
+    }
+
+    return (int)total;
+}
+
+/**
+ * 将哈希表导出为镜像.
+ * 镜像中使用hash_table_hash_bytes和哈希表的种子计算哈希值,与哈希表的哈希函数无关,
+ * key必须是keylen字节的二进制数据或字符串,value按valuesize返回的长度复制.
+ *
+ * @param hashtable: 散列表
+ * @param valuesize: 返回节点value字节数的函数
+ * @param buf: 镜像缓冲区,至少按4字节对齐
+ * @param bufsize: 缓冲区字节数
+ *
+ * @return >0:镜像字节数
+ *         -1:哈希表不存在 或 参数错误
+ *         -2:缓冲区不足
+ */
+int hash_table_image_dump(struct hash_table *hashtable, hash_table_value_size valuesize, void *buf, int bufsize)
+{
+    struct hash_table_node **tables[2];
+    struct hash_table_node *cur = NULL;
+    struct hash_table_image *image = buf;
+    struct hash_table_image_entry *entry = NULL;
+    unsigned int *offset = NULL;
+    unsigned int size = 0, mask = 0, hash = 0, pos = 0;
+    int sizes[2];
+    int i = 0, j = 0, total = 0, keylen = 0, valuelen = 0;
+
+    total = hash_table_image_size(hashtable, valuesize);
+    if (total < 0 || buf == NULL)
+        return -1;
+    if (bufsize < total)
+        return -2;
+
+    tables[0] = hashtable->tables;
+    sizes[0]  = hashtable->size;
+    tables[1] = hashtable->rehash_tables;
+    sizes[1]  = hashtable->rehash_size;
+
+    size = hash_table_image_buckets(hashtable->num);
+    mask = size - 1;
+
+    memset(image, 0, sizeof(*image));
+    image->magic   = HASH_TABLE_IMAGE_MAGIC;
+    image->version = HASH_TABLE_IMAGE_VERSION;
+    image->total   = total;
+    image->size    = size;
+    image->num     = hashtable->num;
+    image->seed    = hashtable->seed;
+    image->keylen  = hashtable->keylen;
+    image->buckets = HASH_TABLE_IMAGE_ALIGN(sizeof(struct hash_table_image));
+
+    offset = (unsigned int *)((char *)image + image->buckets);
+    memset(offset, 0, (size + 1) * sizeof(unsigned int));
+
+    /*第一遍:统计每个哈希桶占用的字节数,放在offset[b+1]中*/
+    for (j = 0; j < 2; j++)
+    {
+        for (i = 0; (tables[j] != NULL) && (i < sizes[j]); i++)
+        {
+            for (cur = tables[j][i]; cur != NULL; cur = cur->next)
+            {
+                keylen = hash_table_image_keylen(hashtable->keylen, cur->key);
+                hash = hash_table_hash_bytes(cur->key, keylen, hashtable->seed);
+                offset[(hash & mask) + 1] += hash_table_image_entry_size(keylen, valuesize(hashtable, cur));
+            }
+        }
+    }
+
+    /*前缀和,offset[b]为哈希桶b的起始偏移*/
+    offset[0] = image->buckets + HASH_TABLE_IMAGE_ALIGN((size + 1) * sizeof(unsigned int));
+    for (pos = 0; pos < size; pos++)
+        offset[pos + 1] += offset[pos];
+
+    /*第二遍:写入节点,写完后offset[b]为哈希桶b的结束偏移*/
+    for (j = 0; j < 2; j++)
+    {
+        for (i = 0; (tables[j] != NULL) && (i < sizes[j]); i++)
+        {
+            for (cur = tables[j][i]; cur != NULL; cur = cur->next)
+            {
+                keylen = hash_table_image_keylen(hashtable->keylen, cur->key);
+                valuelen = valuesize(hashtable, cur);
+                hash = hash_table_hash_bytes(cur->key, keylen, hashtable->seed);
+
+                entry = (struct hash_table_image_entry *)((char *)image + offset[hash & mask]);
+                entry->hash = hash;
+                entry->keylen = keylen;
+                entry->valuelen = valuelen;
+                entry->size = hash_table_image_entry_size(keylen, valuelen);
+                memset(entry + 1, 0, entry->size - sizeof(*entry));
+                memcpy(entry + 1, cur->key, keylen);
+                if (valuelen > 0)
+                    memcpy((char *)(entry + 1) + HASH_TABLE_IMAGE_ALIGN(keylen), cur->value, valuelen);
+
+                offset[hash & mask] += entry->size;
+            }
+        }
+    }
+
+    /*结束偏移右移一位,恢复为起始偏移*/
+    for (pos = size; pos > 0; pos--)
+        offset[pos] = offset[pos - 1];
+    offset[0] = image->buckets + HASH_TABLE_IMAGE_ALIGN((size + 1) * sizeof(unsigned int));
+
+    return total;
+}
+
+/**
+ * 将哈希表导出为镜像文件.
+ *
+ * @param hashtable: 散列表
+ * @param valuesize: 返回节点value字节数的函数
+ * @param path: 文件路径
+ *
+ * @return  0:成功
+ *         -1:哈希表不存在 或 参数错误
+ *         -2:申请内存失败
+ *         -3:文件写入失败
+ */
+int hash_table_image_save(struct hash_table *hashtable, hash_table_value_size valuesize, const char *path)
+{
+    void *buf = NULL;
+    FILE *fp = NULL;
+    int total = 0, ret = 0;
+
+    total = hash_table_image_size(hashtable, valuesize);
+    if (total < 0 || path == NULL)
+        return -1;
+
+    buf = HASH_TABLE_MALLOC(total);
+    if (buf == NULL)
+        return -2;
+
+    hash_table_image_dump(hashtable, valuesize, buf, total);
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        ret = -3;
+    }
+    else
+    {
+        if (fwrite(buf, 1, total, fp) != (size_t)total)
+            ret = -3;
+        if (fclose(fp) != 0)
+            ret = -3;
+    }
+
+    HASH_TABLE_FREE(buf);
+    return ret;
+}
+
+/**
+ * 校验内存中的镜像(mmap映射的文件、XIP的flash或读入内存的数据),不复制也不解析.
+ * 只校验镜像头和哈希桶偏移数组(按8字节对齐、单调不减、不超出镜像),耗时与哈希桶个数成正比,
+ * 不访问节点数据,mmap映射的文件在查找时才按需加载.节点在hash_table_image_search中逐个校验.
+ *
+ * @param addr: 镜像起始地址,至少按4字节对齐,按8字节对齐时value也按8字节对齐
+ * @param len: 可访问的字节数
+ *
+ * @return 镜像, NULL:镜像无效(魔数/版本/字节序不匹配或偏移越界)
+ */
+const struct hash_table_image *hash_table_image_open(const void *addr, int len)
+{
+    const struct hash_table_image *image = addr;
+    const unsigned int *offset = NULL;
+    unsigned int i = 0;
+
+    if (image == NULL || len < (int)sizeof(*image) || ((unsigned long)addr & (sizeof(unsigned int) - 1)) != 0)
+        return NULL;
+
+    if (image->magic != HASH_TABLE_IMAGE_MAGIC || image->version != HASH_TABLE_IMAGE_VERSION)
+        return NULL;
+
+    if (image->total > (unsigned int)len || image->size == 0 || (image->size & (image->size - 1)) != 0 || image->keylen < 0)
+        return NULL;
+
+    if (image->buckets < sizeof(*image) || image->buckets > image->total || (image->buckets & 7) != 0 ||
+        (image->total - image->buckets) / sizeof(unsigned int) < image->size + 1)
+        return NULL;
+
+    /*节点从哈希桶偏移数组之后开始,各哈希桶首尾相接*/
+    offset = HASH_TABLE_IMAGE_BUCKETS(image);
+    if (offset[0] < image->buckets + (image->size + 1) * sizeof(unsigned int))
+        return NULL;
+    for (i = 0; i < image->size; i++)
+    {
+        if ((offset[i] & 7) != 0 || offset[i] > offset[i + 1])
+            return NULL;
+    }
+    if (offset[image->size] > image->total)
+        return NULL;
+
+    return image;
+}
+
+/**
+ * 打开镜像文件.定义HASH_TABLE_USING_MMAP时只读映射文件,否则把文件读入内存(按8字节对齐).
+ *
+ * @param path: 文件路径
+ *
+ * @return 镜像文件,file->image为镜像, NULL:打开失败或镜像无效
+ */
+struct hash_table_image_file *hash_table_image_map(const char *path)
+{
+    struct hash_table_image_file *file = NULL;
+#ifdef HASH_TABLE_USING_MMAP
+    struct stat st;
+    void *addr = NULL;
+    int fd = -1;
+
+    if (path == NULL)
+        return NULL;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(struct hash_table_image))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return NULL;
+
+    file = HASH_TABLE_MALLOC(sizeof(*file));
+    if (file == NULL || hash_table_image_open(addr, (int)st.st_size) == NULL)
+    {
+        if (file != NULL)
+            HASH_TABLE_FREE(file);
+        munmap(addr, st.st_size);
+        return NULL;
+    }
+
+    file->image = addr;
+    file->addr  = addr;
+    file->len   = st.st_size;
+    return file;
+#else
+    FILE *fp = NULL;
+    char *buf = NULL;
+    long len = 0;
+
+    if (path == NULL)
+        return NULL;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL)
+        return NULL;
+
+    if (fseek(fp, 0, SEEK_END) == 0)
+        len = ftell(fp);
+    if (len < (long)sizeof(struct hash_table_image) || fseek(fp, 0, SEEK_SET) != 0)
+    {
+        fclose(fp);
+        return NULL;
+    }
+
+    /*文件头之后多申请7字节,镜像按8字节对齐存放,不依赖堆的对齐*/
+    file = HASH_TABLE_MALLOC(sizeof(*file) + len + 7);
+    if (file == NULL)
+    {
+        fclose(fp);
+        return NULL;
+    }
+    buf = (char *)file + HASH_TABLE_IMAGE_ALIGN((unsigned long)(file + 1)) - (unsigned long)file;
+
+    if (fread(buf, 1, len, fp) != (size_t)len || hash_table_image_open(buf, (int)len) == NULL)
+    {
+        fclose(fp);
+        HASH_TABLE_FREE(file);
+        return NULL;
+    }
+    fclose(fp);
+
+    file->image = (const struct hash_table_image *)buf;
+    file->addr  = file;
+    file->len   = sizeof(*file) + len + 7;
+    return file;
+#endif
+}
+
+/**
+ * 关闭hash_table_image_map打开的镜像文件,按映射时的长度解除映射.
+ */
+void hash_table_image_unmap(struct hash_table_image_file *file)
+{
+    if (file == NULL)
+        return;
+
+#ifdef HASH_TABLE_USING_MMAP
+    munmap(file->addr, file->len);
+#endif
+    HASH_TABLE_FREE(file);
+}
+
+/**
+ * 在镜像中查找key.每个哈希桶的节点连续存放,查找时只顺序访问一段内存.
+ * 访问节点前先校验节点不超出哈希桶、size非0且按8字节对齐、key和value不超出节点,
+ * 只校验查找的哈希桶,损坏的镜像上查找也不会越界访问,遇到无效节点时返回NULL.
+ *
+ * @param image: 镜像,需要先经过hash_table_image_open校验
+ * @param key: 查找的key
+ * @param valuelen: 返回value的字节数,可以为NULL
+ *
+ * @return value在镜像中的地址(只读), NULL:不存在或节点数据无效
+ */
+const void *hash_table_image_search(const struct hash_table_image *image, const void *key, int *valuelen)
+{
+    const struct hash_table_image_entry *entry = NULL;
+    const unsigned int *offset = NULL;
+    unsigned int hash = 0, pos = 0, end = 0;
+    int keylen = 0;
+
+    if (image == NULL || key == NULL)
+        return NULL;
+
+    keylen = hash_table_image_keylen(image->keylen, key);
+    hash = hash_table_hash_bytes(key, keylen, image->seed);
+
+    offset = HASH_TABLE_IMAGE_BUCKETS(image);
+    pos = offset[hash & (image->size - 1)];
+    end = offset[(hash & (image->size - 1)) + 1];
+
+    for (; pos < end; pos += entry->size)
+    {
+        if (end - pos < sizeof(*entry))
+            return NULL;
+
+        /*size为0会导致死循环,未对齐会导致下一个节点非对齐访问*/
+        entry = (const struct hash_table_image_entry *)((const char *)image + pos);
+        if (entry->size < sizeof(*entry) || entry->size > end - pos || (entry->size & 7) != 0 ||
+            entry->keylen > entry->size || entry->valuelen > entry->size ||
+            HASH_TABLE_IMAGE_ALIGN(entry->keylen) + HASH_TABLE_IMAGE_ALIGN(entry->valuelen) > entry->size - sizeof(*entry))
+            return NULL;
+
+        if (entry->hash == hash && entry->keylen == (unsigned int)keylen && memcmp(entry + 1, key, keylen) == 0)
+        {
+            if (valuelen != NULL)
+                *valuelen = entry->valuelen;
+            return (const char *)(entry + 1) + HASH_TABLE_IMAGE_ALIGN(keylen);
+        }
+    }
+
+    return NULL;
+}
+
+
+/*******************************************************************************************
+ *                                          使用示例
+ *******************************************************************************************/
+static int hash_table_image_value_size_sample(struct hash_table *table, struct hash_table_node *node)
+{
+    return strlen(node->value) + 1;
+}
+
+char image_node_read[5][10];
+
+void hash_table_image_sample(void)
+{
+    int i = 0, len = 0, valuelen = 0;
+    char keys[5][10], values[5][10], rd_key[10];
+    struct hash_table *table = NULL;
+    const struct hash_table_image *image = NULL;
+    const char *temp = NULL;
+    void *buf = NULL;
+
+    table = hash_table_creat_default(5, NULL);
+    for (i = 0; i < 5; i++)
+    {
+        sprintf(keys[i], "AAA%d", i);
+        sprintf(values[i], "%d", i + 10);
+        hash_table_insert(table, keys[i], values[i]);
+    }
+
+    /*导出到内存,也可以用hash_table_image_save保存到文件,再用hash_table_image_map打开*/
+    len = hash_table_image_size(table, hash_table_image_value_size_sample);
+    buf = HASH_TABLE_MALLOC(len);
+    hash_table_image_dump(table, hash_table_image_value_size_sample, buf, len);
+    hash_table_destroy(&table);
+
+    image = hash_table_image_open(buf, len);
+    for (i = 0; i < 5; i++)
+    {
+        memset(image_node_read[i], 0, 10);
+        sprintf(rd_key, "AAA%d", i);
+        temp = hash_table_image_search(image, rd_key, &valuelen);
+        if (temp != NULL)
+        {
+            memcpy(image_node_read[i], temp, valuelen);
+        }
+    }
+
+    HASH_TABLE_FREE(buf);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   validate bucket offsets and every entry in hash_table_image_open
+ * 2026-10-17     denghengli   check entries lazily in search, map returns a handle with the mapped length
+ */
+
+#ifndef __ALGO_HASH_TABLE_IMAGE_H__
+#define __ALGO_HASH_TABLE_IMAGE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rtthread.h>
+#include "algo_hash_table.h"
+
+/* 定义后使用mmap映射镜像文件(需要POSIX mmap支持),否则将镜像文件整个读入内存 */
+//#define HASH_TABLE_USING_MMAP
+
+#define HASH_TABLE_IMAGE_MAGIC    0x4D495448 /*"HTIM"*/
+#define HASH_TABLE_IMAGE_VERSION  1
+#define HASH_TABLE_IMAGE_ALIGN(n) (((n) + 7) & ~7)
+
+/*
+ * 哈希表镜像.镜像中只使用相对镜像起始地址的偏移,可以直接映射到任意地址(mmap的文件或XIP的flash)后查找,不需要解析.
+ * 布局: 镜像头 | 哈希桶偏移数组[size+1] | 节点
+ * 每个哈希桶的节点连续存放,哈希桶i的节点在 [offset[i], offset[i+1]) 之间.
+ * 节点: struct hash_table_image_entry | key(按8字节对齐) | value(按8字节对齐)
+ * 镜像中的数据按本机字节序存放,只能在相同字节序的平台上使用.
+ */
+struct hash_table_image
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int total;   /*镜像总字节数*/
+    unsigned int size;    /*哈希桶个数,为2的幂*/
+    unsigned int num;     /*节点个数*/
+    unsigned int seed;    /*哈希种子*/
+    int keylen;           /*key的字节数,0表示key为字符串*/
+    unsigned int buckets; /*哈希桶偏移数组的偏移*/
+};
+
+struct hash_table_image_entry
+{
+    unsigned int hash;     /*hash_table_hash_bytes计算的哈希值*/
+    unsigned int keylen;   /*key的字节数,字符串不包含结束符*/
+    unsigned int valuelen; /*value的字节数*/
+    unsigned int size;     /*整个节点占用的字节数*/
+};
+
+/* hash_table_image_map打开的镜像文件,记录映射(或申请)的地址和长度,文件可以比镜像长 */
+struct hash_table_image_file
+{
+    const struct hash_table_image *image; /*镜像*/
+    void *addr;                           /*映射或申请的起始地址*/
+    unsigned long len;                    /*映射或申请的字节数*/
+};
+
+/* 返回节点value的字节数,导出镜像时value会按该长度复制到镜像中 */
+typedef int (*hash_table_value_size)(struct hash_table *table, struct hash_table_node *node);
+
+extern int hash_table_image_size(struct hash_table *hashtable, hash_table_value_size valuesize);
+extern int hash_table_image_dump(struct hash_table *hashtable, hash_table_value_size valuesize, void *buf, int bufsize);
+extern int hash_table_image_save(struct hash_table *hashtable, hash_table_value_size valuesize, const char *path);
+
+extern const struct hash_table_image *hash_table_image_open(const void *addr, int len);
+extern struct hash_table_image_file *hash_table_image_map(const char *path);
+extern void hash_table_image_unmap(struct hash_table_image_file *file);
+extern const void *hash_table_image_search(const struct hash_table_image *image, const void *key, int *valuelen);
+
+extern void hash_table_image_sample(void);
+
+#endif
@@ -4,30 +4,206 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-12-24     denghengli   the first version
+ * 2026-10-17     denghengli   generic keys (binary/string/pointer) with inline values
+ * 2026-10-17     denghengli   ordered iteration, seek and range scan
+ * 2026-10-17     denghengli   update vectors on the stack, no allocation in search/delete
+ * 2026-10-17     denghengli   per-list xorshift64* level generator with configurable promotion probability
+ * 2026-10-17     denghengli   linear-time bulk build and sorted append
+ * 2026-10-17     denghengli   span widths for O(log n) rank and select (SKIP_LIST_USING_SPAN)
+ * 2026-10-17     denghengli   node arena and key-order compaction
  */
 
 #include "algo_skip_list.h"
 
 /**
- * 动态申请跳表节点.
+ * 默认key比较函数.
+ */
+static int skip_list_keycmp_bytes(struct skip_list *list, const void *key_cmp, const void *key_becmp)
+{
+	return memcmp(key_cmp, key_becmp, list->keysize);
+}
+
+static int skip_list_keycmp_str(struct skip_list *list, const void *key_cmp, const void *key_becmp)
+{
+	return strcmp(key_cmp, key_becmp);
+}
+
+static int skip_list_keycmp_int(struct skip_list *list, const void *key_cmp, const void *key_becmp)
+{
+	int a = *(const int *)key_cmp;
+	int b = *(const int *)key_becmp;
+	
+	return (a > b) - (a < b);
+}
+
+/**
+ * 节点内key数据的字节数,只保存指针时为0.
+ */
+static int skip_list_keylen(struct skip_list *list, const void *key)
+{
+	if (list->keysize > 0)
+		return list->keysize;
+	if (list->keysize == SKIP_LIST_KEY_STR)
+		return strlen(key) + 1;
+	
+	return 0;
+}
+
+/**
+ * 计算节点占用的字节数.
+ */
+static int skip_list_node_size(int level, int keylen, int valuelen)
+{
+	return SKIP_LIST_ALIGN(sizeof(struct skip_list_node) + level * sizeof(struct skip_list_node *) + SKIP_LIST_SPAN_SIZE(level))
+	       + SKIP_LIST_ALIGN(keylen) + valuelen;
+}
+
+/**
+ * 申请节点空间.使用内存池时优先从对应大小的空闲链表中取,其次从当前内存块中顺序分配,
+ * 当前内存块不够时剩余空间放入空闲链表,再取一个新的内存块.
+ * 
+ * @param list:跳表
+ * @param size:节点字节数
+ * @return NULL:内存申请失败
+ */
+static void *skip_list_node_alloc(struct skip_list *list, int size)
+{
+	struct skip_list_chunk *chunk = NULL;
+	void *node = NULL;
+	int idx = 0;
+	
+	if ((list->chunk_size == 0) || (size > SKIP_LIST_ARENA_MAX))
+	{
+		node = SKIP_LIST_MALLOC(size);
+		return node;
+	}
+	
+	size = SKIP_LIST_ALIGN(size);
+	idx = size / 8 - 1;
+	if (list->free_nodes[idx] != NULL)
+	{
+		node = list->free_nodes[idx];
+		list->free_nodes[idx] = *(void **)node;
+		return node;
+	}
+	
+	if (list->arena_left < size)
+	{
+		if (list->spare != NULL)
+		{
+			chunk = list->spare;
+			list->spare = chunk->next;
+		}
+		else
+		{
+			chunk = (struct skip_list_chunk *)SKIP_LIST_MALLOC(SKIP_LIST_ALIGN(sizeof(*chunk)) + list->chunk_size);
+			if (chunk == NULL)
+				return NULL;
+		}
+		
+		/*当前内存块剩余的空间作为空闲节点*/
+		if (list->arena_left >= 8)
+		{
+			idx = list->arena_left / 8 - 1;
+			*(void **)list->arena_cur = list->free_nodes[idx];
+			list->free_nodes[idx] = list->arena_cur;
+		}
+		
+		chunk->next = list->chunks;
+		list->chunks = chunk;
+		list->arena_cur = (char *)chunk + SKIP_LIST_ALIGN(sizeof(*chunk));
+		list->arena_left = list->chunk_size;
+	}
+	
+	node = list->arena_cur;
+	list->arena_cur += size;
+	list->arena_left -= size;
+	
+	return node;
+}
+
+/**
+ * 释放节点.使用内存池时放入对应大小的空闲链表,节点的第一个字用作链表指针.
+ */
+static void skip_list_node_free(struct skip_list *list, struct skip_list_node *node)
+{
+	int size = skip_list_node_size(node->max_level, skip_list_keylen(list, node->key), node->valuelen);
+	int idx = 0;
+	
+	if ((list->chunk_size == 0) || (size > SKIP_LIST_ARENA_MAX))
+	{
+		SKIP_LIST_FREE(node);
+		return;
+	}
+	
+	idx = SKIP_LIST_ALIGN(size) / 8 - 1;
+	*(void **)node = list->free_nodes[idx];
+	list->free_nodes[idx] = node;
+}
+
+/**
+ * 释放内存块链表.
+ */
+static void skip_list_chunk_free(struct skip_list_chunk *chunk)
+{
+	struct skip_list_chunk *next = NULL;
+	
+	while (chunk != NULL)
+	{
+		next = chunk->next;
+		SKIP_LIST_FREE(chunk);
+		chunk = next;
+	}
+}
+
+/**
+ * 动态申请跳表节点.节点、各层索引、key和value数据在同一块空间中.
  * 
+ * @param list:跳表,使用内存池时从内存池分配
+ * @param level:节点层数
+ * @param key:key,keylen为0时只保存指针
+ * @param keylen:复制到节点内的key字节数
+ * @param value:value,valuelen为0时只保存指针
+ * @param valuelen:复制到节点内的value字节数
  * @return NULL:内存申请失败
  *        !NULL:节点创建成功
  */
-static struct skip_list_node* skip_list_node_creat(int level, int key, int value)
+static struct skip_list_node* skip_list_node_creat(struct skip_list *list, int level, const void *key, int keylen, const void *value, int valuelen)
 {
 	struct skip_list_node *node = NULL;
+	int key_offset = 0, value_offset = 0;
 	
-	/* 节点空间大小为 节点数据大小 + level层索引所占用的大小,每一层的next指向同一层下一节点的地址 */
-	node = (struct skip_list_node *)SKIP_LIST_MALLOC(sizeof(*node) + level * sizeof(node));
+	/* 节点空间大小为 节点数据大小 + level层索引(和span)所占用的大小 + key和value数据大小,每一层的next指向同一层下一节点的地址 */
+	key_offset = SKIP_LIST_ALIGN(sizeof(*node) + level * sizeof(node) + SKIP_LIST_SPAN_SIZE(level));
+	value_offset = key_offset + SKIP_LIST_ALIGN(keylen);
+	node = (struct skip_list_node *)skip_list_node_alloc(list, skip_list_node_size(level, keylen, valuelen));
 	if (node == NULL)
 		return NULL;
 	
-	/* 清空申请空间 */
-	memset(node, 0, sizeof(*node) + level * sizeof(node));
-	node->key = key;
-	node->value = value;
+	/* 清空索引空间 */
+	memset(node, 0, sizeof(*node) + level * sizeof(node) + SKIP_LIST_SPAN_SIZE(level));
 	node->max_level = level;
+	node->valuelen = valuelen;
+	
+	if (keylen > 0)
+	{
+		node->key = (char *)node + key_offset;
+		memcpy(node->key, key, keylen);
+	}
+	else
+	{
+		node->key = (void *)key;
+	}
+	
+	if (valuelen > 0)
+	{
+		node->value = (char *)node + value_offset;
+		memcpy(node->value, value, valuelen);
+	}
+	else
+	{
+		node->value = (void *)value;
+	}
 	
 	return node;
 }
@@ -35,21 +211,45 @@ static struct skip_list_node* skip_list_node_creat(int level, int key, int value
 /**
  * 创建跳表头节点.
  * 
- * @param max_level:跳表最大层数
+ * @param max_level:跳表最大层数,不超过SKIP_LIST_MAX_LEVEL
+ * @param keysize:>0:key为keysize字节的数据; SKIP_LIST_KEY_STR:key为字符串; SKIP_LIST_KEY_PTR:只保存key指针
+ * @param keycmp:key比较函数,NULL时数据按memcmp、字符串按strcmp比较
  * @return NULL:创建失败
  *        !NULL:创建成功
  */
-struct skip_list* skip_list_creat(int max_level)
+struct skip_list* skip_list_creat_key(int max_level, int keysize, skip_list_keycmp keycmp)
 {
 	struct skip_list *list = NULL;
 	
+	if (max_level <= 0 || max_level > SKIP_LIST_MAX_LEVEL || keysize < SKIP_LIST_KEY_STR)
+		return NULL;
+	
+	if (keycmp == NULL)
+	{
+		if (keysize == SKIP_LIST_KEY_PTR)
+			return NULL;
+		keycmp = (keysize > 0) ? skip_list_keycmp_bytes : skip_list_keycmp_str;
+	}
+	
 	list = (struct skip_list *)SKIP_LIST_MALLOC(sizeof(*list));
 	if (list == NULL)
 		return NULL;
 	
 	list->level = 1;
 	list->num = 0;
-	list->head = skip_list_node_creat(max_level, 0, 0);
+	list->keysize = keysize;
+	list->keycmp = keycmp;
+	list->rng = ((unsigned long long)rt_tick_get() << 32) ^ (unsigned long)list ^ 0x9E3779B97F4A7C15ULL;
+	if (list->rng == 0)
+		list->rng = 0x9E3779B97F4A7C15ULL;
+	skip_list_set_p(list, SKIP_LIST_P);
+	list->chunk_size = 0;
+	list->arena_left = 0;
+	list->arena_cur = NULL;
+	list->chunks = NULL;
+	list->spare = NULL;
+	memset(list->free_nodes, 0, sizeof(list->free_nodes));
+	list->head = skip_list_node_creat(list, max_level, NULL, 0, NULL, 0);
 	if (list->head == NULL)
 	{
 		SKIP_LIST_FREE(list);
@@ -60,7 +260,52 @@ struct skip_list* skip_list_creat(int max_level)
 }
 
 /**
- * 随机产生插入元素的索引层数,随机产生的.
+ * 创建key和value为int的跳表.
+ * 
+ * @param max_level:跳表最大层数
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct skip_list* skip_list_creat(int max_level)
+{
+	return skip_list_creat_key(max_level, sizeof(int), skip_list_keycmp_int);
+}
+
+/**
+ * 每个跳表独立的xorshift64*随机数,不使用全局的rand().
+ */
+static unsigned long long skip_list_rand(struct skip_list *list)
+{
+	unsigned long long x = list->rng;
+	
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	list->rng = x;
+	
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+#ifndef SKIP_LIST_CTZ64
+static int skip_list_ctz64(unsigned long long x)
+{
+	int n = 0;
+	
+	while ((x & 1) == 0)
+	{
+		x >>= 1;
+		n++;
+	}
+	
+	return n;
+}
+#define SKIP_LIST_CTZ64(x)       skip_list_ctz64(x)
+#endif
+
+/**
+ * 随机产生插入元素的索引层数,层数服从晋升概率为p的几何分布.
+ * p为1/2^p_bits时,随机数低位连续0的个数除以p_bits即为晋升的层数,一次随机数即可确定层数;
+ * 其他p每层取随机数的16位与p比较,4层用完后再取下一个随机数.
  * 
  * @param list:跳表
  * @return 节点索引层数
@@ -68,265 +313,840 @@ struct skip_list* skip_list_creat(int max_level)
  */
 static int skip_list_level(struct skip_list *list)
 {
-	int i = 0, level = 1; /*索引层数至少为1,所以从1开始*/
+	unsigned long long r = skip_list_rand(list);
+	int n = 0, level = 1; /*索引层数至少为1,所以从1开始*/
 	
-	for (i=1; i<list->head->max_level; i++)
+	if (list->p_bits > 0)
 	{
-		if ((rand() % 2) == 1)
+		level += (r == 0) ? list->head->max_level : (SKIP_LIST_CTZ64(r) / list->p_bits);
+	}
+	else
+	{
+		while ((level < list->head->max_level) && ((int)(r & 0xFFFF) < list->p))
 		{
 			level++;
+			r >>= 16;
+			if (++n == 4)
+			{
+				r = skip_list_rand(list);
+				n = 0;
+			}
 		}
 	}
-	return level;
+	
+	return (level < list->head->max_level) ? level : list->head->max_level;
 }
 
 /**
- * 插入跳表节点.
+ * 设置节点晋升到上一层的概率,只影响之后插入的节点.
+ * p小时节点平均层数少、内存占用小,但查找时每层比较的次数多.
  * 
  * @param list:跳表
- * @param key:
- * @param value:
- * @return -1:跳表为空
- *         -2:空间分配失败
- *         -3:key已经存在
- *          0:插入成功
+ * @param p:晋升概率,以65536为1,如SKIP_LIST_P_1_2、SKIP_LIST_P_1_4、SKIP_LIST_P_1_E
+ * @return -1:跳表为空 或 p不在(0, 65536)范围内
+ *          0:成功
  */
-int skip_list_insert(struct skip_list *list, int key, int value)
+int skip_list_set_p(struct skip_list *list, int p)
 {
-	struct skip_list_node **update = NULL; /*用来更新每层索引指针，存放插入位置的前驱各层节点索引*/ 
-	struct skip_list_node *cur = NULL;
-	struct skip_list_node *prev = NULL;
-	struct skip_list_node *insert = NULL;
-	int i = 0, level = 0;
+	int bits = 0;
 	
-	if (list == NULL)
+	if (list == NULL || p <= 0 || p >= 65536)
 		return -1;
 	
-	/*申请update空间用于保存每层的索引指针*/
-	update = (struct skip_list_node **)SKIP_LIST_MALLOC(sizeof(list->head->max_level * sizeof(struct skip_list_node *)));
-	if (update == NULL)
-		return -2;
-	
-	/*逐层查询,查找插入位置的前驱各层节点索引
-	 *update[0] 存放第一层的插入位置前驱节点，update[0]->next[0]表示插入位置的前驱节点的下一节点(update[0]->next[0])的第一层索引值
-	 *update[1] 存放第二层的插入位置前驱节点，update[1]->next[1]表示插入位置的前驱节点的下一节点(update[1]->next[0])的第二层索引值
-	 *update[n] 存放第一层的插入位置前驱节点，update[n]->next[n]表示插入位置的前驱节点的下一节点(update[n]->next[0])的第n层索引值
-	 */
-	prev = list->head; /*从第一个节点开始的最上层开始找*/
-	i = list->level - 1;
-	for(; i>=0; i--)
+	list->p = p;
+	list->p_bits = 0;
+	for (bits = 1; (65536 >> bits) >= p; bits++)
 	{
-		/* 各层每个节点的下一个节点不为空 && 下个节点的key小于要插入的key */
-		while ( ((cur = prev->next[i]) != NULL) && (cur->key < key) )
+		if ((65536 >> bits) == p)
 		{
-			prev = cur; /* 向后移动 */
+			list->p_bits = bits;
+			break;
 		}
-		update[i] = prev; /* 各层要插入节点的前驱节点 */
-	}
-	
-	/* 当前key已经存在,返回错误 */
-	if ((cur != NULL) && (cur->key == key))
-	{
-		return -3;
 	}
 	
-	/*获取插入元素的随机层数,并更新跳表的最大层数*/
-	level = skip_list_level(list);
-	/*创建当前节点*/
-	insert = skip_list_node_creat(level, key, value);
-	/*根据最大索引层数,更新插入节点的前驱节点,前面已经更新到了[0] - [(list->level-1)]*/
-	if (level > list->level)
-	{
-		for (i=list->level; i<level; i++)
-		{
-			update[i] = list->head;/*这部分为多新增的索引层,所以前驱节点默认为头结点*/
-		}
-		list->level = level;/*更新跳表的最大索引层数*/
-	}
+	return 0;
+}
+
+/**
+ * 使用内存池分配节点.节点从chunk_size大小的内存块中连续分配,减少内存申请次数和碎片,
+ * 相邻插入的节点在内存中也相邻.只能在跳表为空时设置,设置后不能取消.
+ * 
+ * @param list:跳表
+ * @param chunk_size:内存块大小,0时使用SKIP_LIST_ARENA_CHUNK,不小于SKIP_LIST_ARENA_MAX
+ * @return -1:跳表为空 或 跳表中已有节点 或 已经设置过 或 chunk_size太小
+ *          0:成功
+ */
+int skip_list_set_arena(struct skip_list *list, int chunk_size)
+{
+	if (list == NULL || list->num != 0 || list->chunk_size != 0)
+		return -1;
 	
-	/*逐层更新节点的指针*/
-	for (i=0; i<level; i++)
-	{
-		insert->next[i] = update[i]->next[i];
-		update[i]->next[i] = insert;
-	}
+	if (chunk_size == 0)
+		chunk_size = SKIP_LIST_ARENA_CHUNK;
+	if (chunk_size < SKIP_LIST_ARENA_MAX)
+		return -1;
 	
-	/*节点数目加1*/
-	list->num++;
+	list->chunk_size = SKIP_LIST_ALIGN(chunk_size);
 	
 	return 0;
 }
 
 /**
- * 删除跳表节点.
+ * 整理内存池,把节点按key从小到大复制到新的内存块中,之后第一层相邻的节点在内存中也相邻,
+ * 顺序遍历和第一层的查找都是顺序访问内存.随机插入/删除较多后调用,复杂度为O(n).
+ * 需要的内存块先全部申请,申请失败时跳表不变.超过SKIP_LIST_ARENA_MAX字节的节点不移动.
  * 
  * @param list:跳表
- * @param key:
- * @param value:
- * @return -1:跳表为空 或 跳表节点数量为0
+ * @return -1:跳表为空 或 没有使用内存池
  *         -2:空间分配失败
- *         -3:key不存在
- *          0:删除成功
+ *          0:成功
  */
-int skip_list_delete(struct skip_list *list, int key)
+int skip_list_compact(struct skip_list *list)
 {
-	struct skip_list_node **update = NULL; /*用来更新每层索引指针，存放插入位置的前驱各层节点索引*/ 
+	struct skip_list_node *last[SKIP_LIST_MAX_LEVEL]; /*各层的最后一个节点*/
+	struct skip_list_chunk *old = NULL;
+	struct skip_list_chunk *chunk = NULL;
 	struct skip_list_node *cur = NULL;
-	struct skip_list_node *prev = NULL;
-	int i = 0;
+	struct skip_list_node *next = NULL;
+	struct skip_list_node *node = NULL;
+	int i = 0, size = 0, left = 0, need = 0;
 	
-	if (list == NULL && list->num == 0)
+	if (list == NULL || list->chunk_size == 0)
 		return -1;
 	
-	/*申请update空间用于保存每层的节点索引指针*/
-	update = (struct skip_list_node **)SKIP_LIST_MALLOC(sizeof(list->level * sizeof(struct skip_list_node *)));
-	if (update == NULL)
-		return -2;
+	/*按顺序分配计算需要的内存块数*/
+	for (cur = list->head->next[0]; cur != NULL; cur = cur->next[0])
+	{
+		size = skip_list_node_size(cur->max_level, skip_list_keylen(list, cur->key), cur->valuelen);
+		if (size > SKIP_LIST_ARENA_MAX)
+			continue;
+		size = SKIP_LIST_ALIGN(size);
+		if (left < size)
+		{
+			need++;
+			left = list->chunk_size;
+		}
+		left -= size;
+	}
 	
-	/*逐层查询,查找删除位置的前驱各层节点索引
-	 *update[0] 存放第一层的删除位置前驱节点，update[0]->next[0]表示删除位置的前驱节点的下一节点(update[0]->next[0])的第一层索引值
-	 *update[1] 存放第二层的删除位置前驱节点，update[1]->next[1]表示删除位置的前驱节点的下一节点(update[1]->next[0])的第二层索引值
-	 *update[n] 存放第一层的删除位置前驱节点，update[n]->next[n]表示删除位置的前驱节点的下一节点(update[n]->next[0])的第n层索引值
-	 */
-	prev = list->head; /*从第一个节点开始的最上层开始找*/
-	i = list->level - 1;
-	for(; i>=0; i--)
+	for (i = 0; i < need; i++)
 	{
-		/* 各层每个节点的下一个节点不为空 && 下个节点的key小于要插入的key */
-		while ( ((cur = prev->next[i]) != NULL) && (cur->key < key) )
+		chunk = (struct skip_list_chunk *)SKIP_LIST_MALLOC(SKIP_LIST_ALIGN(sizeof(*chunk)) + list->chunk_size);
+		if (chunk == NULL)
 		{
-			prev = cur; /* 向后移动 */
+			skip_list_chunk_free(list->spare);
+			list->spare = NULL;
+			return -2;
 		}
-		update[i] = prev; /* 各层要删除节点的前驱节点 */
+		chunk->next = list->spare;
+		list->spare = chunk;
+	}
+	
+	/*之后从新的内存块分配,原来的内存块和空闲链表整理完后丢弃*/
+	old = list->chunks;
+	list->chunks = NULL;
+	list->arena_cur = NULL;
+	list->arena_left = 0;
+	memset(list->free_nodes, 0, sizeof(list->free_nodes));
+	
+	for (i = 0; i < list->head->max_level; i++)
+	{
+		last[i] = list->head;
 	}
 	
-	/* 当前key存在 */
-	if ((cur != NULL) && (cur->key == key))
+	for (cur = list->head->next[0]; cur != NULL; cur = next)
 	{
-		/*逐层删除*/
-		for(i=0; i<list->level; i++)
+		next = cur->next[0];
+		size = skip_list_node_size(cur->max_level, skip_list_keylen(list, cur->key), cur->valuelen);
+		if (size > SKIP_LIST_ARENA_MAX)
 		{
-			if (update[i]->next[i] == cur)
-			{
-				update[i]->next[i] = cur->next[i];
-			}
+			node = cur;
 		}
-		
-		SKIP_LIST_FREE(cur);
-		cur = NULL;
-		
-		/*更新索引的层数*/
-		for(i=list->level-1; i>=0; i--)
+		else
 		{
-			/*如果删除节点后,某层的头结点后驱节点为空,则说明该层无索引指针,索引层数需要减1*/
-			if (list->head->next[i] == NULL) 
+			/*复制节点,span不变,key和value在节点内时指向新节点内的数据*/
+			node = (struct skip_list_node *)skip_list_node_alloc(list, size);
+			memcpy(node, cur, size);
+			if (skip_list_keylen(list, cur->key) > 0)
 			{
-				list->level --;
+				node->key = (char *)node + ((char *)cur->key - (char *)cur);
 			}
-			else 
+			if (cur->valuelen > 0)
 			{
-				break;
+				node->value = (char *)node + ((char *)cur->value - (char *)cur);
 			}
 		}
 		
-		list->num --; /*节点数减1*/
+		for (i = 0; i < node->max_level; i++)
+		{
+			last[i]->next[i] = node;
+			last[i] = node;
+		}
 	}
-	else
+	
+	for (i = 0; i < list->head->max_level; i++)
 	{
-		return -3;
+		last[i]->next[i] = NULL;
 	}
 	
+	skip_list_chunk_free(old);
+	
 	return 0;
 }
 
 /**
- * 查询当前key是否在跳表中,存在修改key对于的value数值.
+ * 逐层查询,查找第一个不小于key的节点,并记录各层的前驱节点.
+ * update[0] 存放第一层的前驱节点，update[0]->next[0]表示前驱节点的下一节点的第一层索引值
+ * update[n] 存放第n+1层的前驱节点，update[n]->next[n]表示前驱节点的下一节点的第n+1层索引值
  * 
  * @param list:跳表
- * @param key:修改key
- * @param value:修改的数据
- * @return -1:跳表为空 或 跳表节点数量为0
- *         -3:key不存在
- *          0:修改成功
+ * @param key:查找的key
+ * @param update:返回各层的前驱节点,不需要时为NULL
+ * @param rank:返回各层前驱节点的排名(头节点为0),rank[0]即小于key的节点个数,未定义SKIP_LIST_USING_SPAN时都为0,不需要时为NULL
+ * @return 第一个不小于key的节点, NULL:所有节点都小于key
  */
-int skip_list_modify(struct skip_list *list, int key, int value)
+static struct skip_list_node *skip_list_find(struct skip_list *list, const void *key, struct skip_list_node **update, int *rank)
 {
 	struct skip_list_node *cur = NULL;
 	struct skip_list_node *prev = NULL;
-	int i = 0;
+	int i = 0, traversed = 0;
 	
-	if (list == NULL && list->num == 0)
-		return -1;
-	
-	/*逐层查找,查找查询位置原始链表的节点*/
 	prev = list->head; /*从第一个节点开始的最上层开始找*/
-	i = list->level - 1;
-	for(; i>=0; i--)
+	for (i = list->level - 1; i >= 0; i--)
 	{
-		/* 各层每个节点的下一个节点不为空 && 下个节点的key小于要插入的key */
-		while ( ((cur = prev->next[i]) != NULL) && (cur->key < key) )
+		/* 各层每个节点的下一个节点不为空 && 下个节点的key小于要查找的key */
+		while ( ((cur = prev->next[i]) != NULL) && (list->keycmp(list, key, cur->key) > 0) )
 		{
+#ifdef SKIP_LIST_USING_SPAN
+			traversed += SKIP_LIST_SPAN(prev)[i];
+#endif
 			prev = cur; /* 向后移动 */
 		}
+		if (update != NULL)
+		{
+			update[i] = prev;
+		}
+		if (rank != NULL)
+		{
+			rank[i] = traversed;
+		}
 	}
 	
-	/* 当前key存在 */
-	if ((cur != NULL) && (cur->key == key))
-	{
-		cur->value = value;
-	}
-	else
-	{
-		return -3;
-	}
-	
-	return 0;
+	return cur;
 }
 
 /**
- * 查询当前key是否在跳表中,存在返回查询的value数值.
+ * 插入跳表节点.各层前驱节点保存在栈上,除新节点外不申请内存.
  * 
  * @param list:跳表
- * @param key:
- * @param value:查询的数据
- * @return -1:跳表为空 或 跳表节点数量为0
- *         -3:key不存在
- *          0:查找成功
+ * @param key:按创建时的keysize复制到节点内,或只保存指针
+ * @param value:valuelen>0时复制valuelen字节到节点内,否则只保存指针
+ * @param valuelen:value的字节数
+ * @return -1:跳表为空
+ *         -2:空间分配失败
+ *         -3:key已经存在
+ *          0:插入成功
  */
-int skip_list_search(struct skip_list *list, int key, int *value)
+int skip_list_insert_key(struct skip_list *list, const void *key, const void *value, int valuelen)
 {
+	struct skip_list_node *update[SKIP_LIST_MAX_LEVEL]; /*用来更新每层索引指针，存放插入位置的前驱各层节点索引*/
+	int rank[SKIP_LIST_MAX_LEVEL]; /*各层前驱节点的排名,用于更新span*/
 	struct skip_list_node *cur = NULL;
-	struct skip_list_node *prev = NULL;
-	int i = 0;
+	struct skip_list_node *insert = NULL;
+	int i = 0, level = 0;
 	
-	if (list == NULL && value == NULL && list->num == 0)
+	if (list == NULL || key == NULL || valuelen < 0)
 		return -1;
 	
-	/*逐层查找,查找查询位置原始链表的节点*/
-	prev = list->head; /*从第一个节点开始的最上层开始找*/
-	i = list->level - 1;
-	for(; i>=0; i--)
+	/* 当前key已经存在,返回错误 */
+	cur = skip_list_find(list, key, update, rank);
+	if ((cur != NULL) && (list->keycmp(list, key, cur->key) == 0))
+		return -3;
+	
+	/*获取插入元素的随机层数,创建当前节点*/
+	level = skip_list_level(list);
+	insert = skip_list_node_creat(list, level, key, skip_list_keylen(list, key), value, valuelen);
+	if (insert == NULL)
+		return -2;
+	
+	/*根据最大索引层数,更新插入节点的前驱节点,前面已经更新到了[0] - [(list->level-1)]*/
+	if (level > list->level)
 	{
-		/* 各层每个节点的下一个节点不为空 && 下个节点的key小于要插入的key */
-		while ( ((cur = prev->next[i]) != NULL) && (cur->key < key) )
+		for (i=list->level; i<level; i++)
 		{
-			prev = cur; /* 向后移动 */
+			update[i] = list->head;/*这部分为多新增的索引层,所以前驱节点默认为头结点*/
+			rank[i] = 0;
+#ifdef SKIP_LIST_USING_SPAN
+			SKIP_LIST_SPAN(list->head)[i] = list->num;
+#endif
 		}
+		list->level = level;/*更新跳表的最大索引层数*/
 	}
 	
-	/* 当前key存在 */
-	if ((cur != NULL) && (cur->key == key))
+	/*逐层更新节点的指针*/
+	for (i=0; i<level; i++)
 	{
-		*value = cur->value;
+		insert->next[i] = update[i]->next[i];
+		update[i]->next[i] = insert;
+#ifdef SKIP_LIST_USING_SPAN
+		/*前驱节点的span在插入位置一分为二,rank[0] - rank[i]为该层前驱节点到插入位置之间的节点数*/
+		SKIP_LIST_SPAN(insert)[i] = SKIP_LIST_SPAN(update[i])[i] - (rank[0] - rank[i]);
+		SKIP_LIST_SPAN(update[i])[i] = rank[0] - rank[i] + 1;
+#endif
 	}
-	else
+	
+#ifdef SKIP_LIST_USING_SPAN
+	/*高于新节点的层,前驱节点跨过了新节点*/
+	for (i=level; i<list->level; i++)
 	{
-		return -3;
+		SKIP_LIST_SPAN(update[i])[i]++;
+	}
+#endif
+	
+	/*节点数目加1*/
+	list->num++;
+	
+	return 0;
+}
+
+/**
+ * 删除跳表节点.
+ * 
+ * @param list:跳表
+ * @param key:
+ * @return -1:跳表为空 或 跳表节点数量为0
+ *         -3:key不存在
+ *          0:删除成功
+ */
+int skip_list_delete_key(struct skip_list *list, const void *key)
+{
+	struct skip_list_node *update[SKIP_LIST_MAX_LEVEL]; /*用来更新每层索引指针，存放删除位置的前驱各层节点索引*/
+	struct skip_list_node *cur = NULL;
+	int i = 0;
+	
+	if (list == NULL || key == NULL || list->num == 0)
+		return -1;
+	
+	/* 当前key不存在 */
+	cur = skip_list_find(list, key, update, NULL);
+	if ((cur == NULL) || (list->keycmp(list, key, cur->key) != 0))
+		return -3;
+	
+	/*逐层删除*/
+	for(i=0; i<list->level; i++)
+	{
+		if (update[i]->next[i] == cur)
+		{
+			update[i]->next[i] = cur->next[i];
+#ifdef SKIP_LIST_USING_SPAN
+			SKIP_LIST_SPAN(update[i])[i] += SKIP_LIST_SPAN(cur)[i] - 1;
+		}
+		else
+		{
+			SKIP_LIST_SPAN(update[i])[i]--;
+#endif
+		}
+	}
+	
+	skip_list_node_free(list, cur);
+	cur = NULL;
+	
+	/*更新索引的层数,如果删除节点后,某层的头结点后驱节点为空,则说明该层无索引指针,索引层数需要减1*/
+	while ((list->level > 1) && (list->head->next[list->level - 1] == NULL))
+	{
+		list->level --;
+	}
+	
+	list->num --; /*节点数减1*/
+	
+	return 0;
+}
+
+/**
+ * 查询当前key是否在跳表中,存在修改key对应的value.
+ * value字节数与原来相同或只保存指针时直接修改,否则重新申请节点替换原来的节点.
+ * 
+ * @param list:跳表
+ * @param key:修改key
+ * @param value:修改的数据
+ * @param valuelen:value的字节数,0表示只保存指针
+ * @return -1:跳表为空 或 跳表节点数量为0
+ *         -2:空间分配失败
+ *         -3:key不存在
+ *          0:修改成功
+ */
+int skip_list_modify_key(struct skip_list *list, const void *key, const void *value, int valuelen)
+{
+	struct skip_list_node *update[SKIP_LIST_MAX_LEVEL];
+	struct skip_list_node *cur = NULL;
+	struct skip_list_node *node = NULL;
+	int i = 0;
+	
+	if (list == NULL || key == NULL || valuelen < 0 || list->num == 0)
+		return -1;
+	
+	cur = skip_list_find(list, key, update, NULL);
+	if ((cur == NULL) || (list->keycmp(list, key, cur->key) != 0))
+		return -3;
+	
+	if ((valuelen == 0) && (cur->valuelen == 0))
+	{
+		cur->value = (void *)value;
+	}
+	else if (valuelen == cur->valuelen)
+	{
+		memcpy(cur->value, value, valuelen);
+	}
+	else
+	{
+		/*value大小变化,用同样层数的新节点替换*/
+		node = skip_list_node_creat(list, cur->max_level, cur->key, skip_list_keylen(list, cur->key), value, valuelen);
+		if (node == NULL)
+			return -2;
+		for (i=0; i<cur->max_level; i++)
+		{
+			node->next[i] = cur->next[i];
+			update[i]->next[i] = node;
+#ifdef SKIP_LIST_USING_SPAN
+			SKIP_LIST_SPAN(node)[i] = SKIP_LIST_SPAN(cur)[i];
+#endif
+		}
+		skip_list_node_free(list, cur);
 	}
 	
 	return 0;
 }
 
+/**
+ * 查询当前key是否在跳表中,存在返回查询的value.
+ * 
+ * @param list:跳表
+ * @param key:
+ * @param value:返回value指针(节点内的数据或插入时的指针),不需要时为NULL
+ * @param valuelen:返回节点内value的字节数,不需要时为NULL
+ * @return -1:跳表为空 或 跳表节点数量为0
+ *         -3:key不存在
+ *          0:查找成功
+ */
+int skip_list_search_key(struct skip_list *list, const void *key, void **value, int *valuelen)
+{
+	struct skip_list_node *cur = NULL;
+	
+	if (list == NULL || key == NULL || list->num == 0)
+		return -1;
+	
+	/* 当前key不存在 */
+	cur = skip_list_find(list, key, NULL, NULL);
+	if ((cur == NULL) || (list->keycmp(list, key, cur->key) != 0))
+		return -3;
+	
+	if (value != NULL)
+		*value = cur->value;
+	if (valuelen != NULL)
+		*valuelen = cur->valuelen;
+	
+	return 0;
+}
+
+/**
+ * 按节点序号确定层数,序号能被 1/p 整除k次的节点层数为k+1,得到每层节点均匀分布的跳表.
+ * 
+ * @param index:节点序号,从1开始
+ */
+static int skip_list_level_index(struct skip_list *list, int index)
+{
+	int step = (65536 + list->p / 2) / list->p; /*1/p四舍五入*/
+	int level = 1;
+	
+	if (step < 2)
+		step = 2;
+	
+	while (((index % step) == 0) && (level < list->head->max_level))
+	{
+		level++;
+		index /= step;
+	}
+	
+	return level;
+}
+
+/**
+ * 把严格递增且都大于跳表中最大key的一组key依次链接到跳表末尾.
+ * 先从最高层开始找到各层的最后一个节点,之后每个节点只需要链接到各层末尾,不需要再从头查找,总的复杂度为O(log n + num).
+ * 节点层数按序号确定而不是随机产生,从空跳表构建时各层节点分布均匀.
+ * 
+ * @param list:跳表
+ * @param keys:key数组,按key从小到大排列
+ * @param values:value数组,valuelen>0时复制valuelen字节到节点内,否则只保存指针
+ * @param num:key的个数
+ * @param valuelen:value的字节数
+ * @return -1:跳表为空 或 keys为空 或 values为空
+ *         -2:第一个节点空间分配失败
+ *         -3:第一个key不大于跳表中最大的key
+ *        >=0:链接的节点个数,小于num时表示keys[返回值]不是严格递增或空间分配失败,之后的key都没有链接
+ */
+int skip_list_append_sorted(struct skip_list *list, void **keys, void **values, int num, int valuelen)
+{
+	struct skip_list_node *last[SKIP_LIST_MAX_LEVEL]; /*各层的最后一个节点*/
+#ifdef SKIP_LIST_USING_SPAN
+	int rank[SKIP_LIST_MAX_LEVEL]; /*各层最后一个节点的排名*/
+	int traversed = 0;
+#endif
+	struct skip_list_node *node = NULL;
+	int i = 0, n = 0, level = 0;
+	
+	if (list == NULL || keys == NULL || values == NULL || num < 0 || valuelen < 0)
+		return -1;
+	
+	/*逐层找到最后一个节点*/
+	node = list->head;
+	for (i = list->head->max_level - 1; i >= 0; i--)
+	{
+		while (node->next[i] != NULL)
+		{
+#ifdef SKIP_LIST_USING_SPAN
+			traversed += SKIP_LIST_SPAN(node)[i];
+#endif
+			node = node->next[i];
+		}
+		last[i] = node;
+#ifdef SKIP_LIST_USING_SPAN
+		rank[i] = traversed;
+#endif
+	}
+	
+	for (n = 0; n < num; n++)
+	{
+		/*key必须大于前一个节点的key*/
+		if ((last[0] != list->head) && (list->keycmp(list, keys[n], last[0]->key) <= 0))
+			break;
+		
+		level = skip_list_level_index(list, list->num + 1);
+		node = skip_list_node_creat(list, level, keys[n], skip_list_keylen(list, keys[n]), values[n], valuelen);
+		if (node == NULL)
+			break;
+		
+		for (i = 0; i < level; i++)
+		{
+			last[i]->next[i] = node;
+#ifdef SKIP_LIST_USING_SPAN
+			SKIP_LIST_SPAN(last[i])[i] = list->num + 1 - rank[i];
+			rank[i] = list->num + 1;
+#endif
+			last[i] = node;
+		}
+		if (level > list->level)
+		{
+			list->level = level;
+		}
+		list->num++;
+	}
+	
+#ifdef SKIP_LIST_USING_SPAN
+	/*各层最后一个节点的span为到表尾的节点数*/
+	for (i = 0; i < list->head->max_level; i++)
+	{
+		SKIP_LIST_SPAN(last[i])[i] = list->num - rank[i];
+	}
+#endif
+	
+	if ((n == 0) && (num > 0))
+		return (node == NULL) ? -2 : -3;
+	
+	return n;
+}
+
+/**
+ * 从严格递增的key数组构建跳表,跳表必须为空.
+ * 每个节点只链接到各层末尾,复杂度为O(n),逐个插入需要O(n log n).
+ * 
+ * @return -1:跳表为空 或 跳表中已有节点 或 keys为空 或 values为空
+ *         -2:第一个节点空间分配失败
+ *        >=0:构建的节点个数,小于num时表示keys[返回值]不是严格递增或空间分配失败
+ */
+int skip_list_build_sorted(struct skip_list *list, void **keys, void **values, int num, int valuelen)
+{
+	if (list == NULL || list->num != 0)
+		return -1;
+	
+	return skip_list_append_sorted(list, keys, values, num, valuelen);
+}
+
+/**
+ * 返回跳表中key最小的节点.
+ * 
+ * @param list:跳表
+ * @return NULL:跳表为空
+ */
+struct skip_list_node* skip_list_first(struct skip_list *list)
+{
+	if (list == NULL)
+		return NULL;
+	
+	return list->head->next[0];
+}
+
+/**
+ * 返回下一个节点(按key从小到大).
+ * 
+ * @param node:当前节点
+ * @return NULL:node为最后一个节点
+ */
+struct skip_list_node* skip_list_next(struct skip_list_node *node)
+{
+	if (node == NULL)
+		return NULL;
+	
+	return node->next[0];
+}
+
+/**
+ * 定位到第一个不小于key的节点(lower bound),之后可以用skip_list_next顺序遍历.
+ * 
+ * @param list:跳表
+ * @param key:查找的key,NULL时返回第一个节点
+ * @return NULL:所有节点都小于key
+ */
+struct skip_list_node* skip_list_seek(struct skip_list *list, const void *key)
+{
+	if (list == NULL)
+		return NULL;
+	
+	if (key == NULL)
+		return list->head->next[0];
+	
+	return skip_list_find(list, key, NULL, NULL);
+}
+
+/**
+ * 范围遍历,按key从小到大对 min <= key <= max 的节点调用fun.
+ * 先用O(log n)定位到min,再沿第一层链表顺序访问,总的复杂度为O(log n + k).
+ * 
+ * @param list:跳表
+ * @param min:范围下限,NULL表示从第一个节点开始
+ * @param max:范围上限,NULL表示到最后一个节点
+ * @param fun:节点处理函数,返回非0时停止遍历; NULL时只计数
+ * @param param:传给fun的参数
+ * @return -1:跳表为空
+ *        >=0:访问的节点个数
+ */
+int skip_list_range(struct skip_list *list, const void *min, const void *max, skip_list_visit_fun fun, void *param)
+{
+	struct skip_list_node *cur = NULL;
+	int n = 0;
+	
+	if (list == NULL)
+		return -1;
+	
+	for (cur = skip_list_seek(list, min); cur != NULL; cur = cur->next[0])
+	{
+		if ((max != NULL) && (list->keycmp(list, max, cur->key) < 0))
+			break;
+		
+		n++;
+		if ((fun != NULL) && (fun(list, cur, param) != 0))
+			break;
+	}
+	
+	return n;
+}
+
+/**
+ * 统计 min <= key <= max 的节点个数.
+ * 定义SKIP_LIST_USING_SPAN时用两端的排名相减,复杂度为O(log n),否则需要遍历范围内的节点.
+ * 
+ * @param list:跳表
+ * @param min:范围下限,NULL表示不限
+ * @param max:范围上限,NULL表示不限
+ * @return -1:跳表为空
+ *        >=0:节点个数
+ */
+int skip_list_count(struct skip_list *list, const void *min, const void *max)
+{
+#ifdef SKIP_LIST_USING_SPAN
+	int rank[SKIP_LIST_MAX_LEVEL];
+	struct skip_list_node *cur = NULL;
+	int lower = 0, upper = 0;
+	
+	if (list == NULL)
+		return -1;
+	
+	/*小于min的节点个数*/
+	if (min != NULL)
+	{
+		skip_list_find(list, min, NULL, rank);
+		lower = rank[0];
+	}
+	
+	/*不大于max的节点个数*/
+	upper = list->num;
+	if (max != NULL)
+	{
+		cur = skip_list_find(list, max, NULL, rank);
+		upper = rank[0];
+		if ((cur != NULL) && (list->keycmp(list, max, cur->key) == 0))
+			upper++;
+	}
+	
+	return (upper > lower) ? (upper - lower) : 0;
+#else
+	return skip_list_range(list, min, max, NULL, NULL);
+#endif
+}
+
+#ifdef SKIP_LIST_USING_SPAN
+/**
+ * 查询key的排名,按key从小到大第一个节点的排名为1.
+ * 查找时累加经过的各层span,复杂度为O(log n).
+ * 
+ * @param list:跳表
+ * @param key:
+ * @return -1:跳表为空 或 跳表节点数量为0
+ *         -3:key不存在
+ *         >0:排名
+ */
+int skip_list_rank(struct skip_list *list, const void *key)
+{
+	int rank[SKIP_LIST_MAX_LEVEL];
+	struct skip_list_node *cur = NULL;
+	
+	if (list == NULL || key == NULL || list->num == 0)
+		return -1;
+	
+	cur = skip_list_find(list, key, NULL, rank);
+	if ((cur == NULL) || (list->keycmp(list, key, cur->key) != 0))
+		return -3;
+	
+	return rank[0] + 1;
+}
+
+/**
+ * 返回排名为rank的节点.从最高层开始,span不超过剩余排名时向后移动,否则下降一层,复杂度为O(log n).
+ * 
+ * @param list:跳表
+ * @param rank:排名,从1开始
+ * @return NULL:跳表为空 或 rank不在[1, num]范围内
+ */
+struct skip_list_node* skip_list_select(struct skip_list *list, int rank)
+{
+	struct skip_list_node *cur = NULL;
+	int i = 0, traversed = 0;
+	
+	if (list == NULL || rank < 1 || rank > list->num)
+		return NULL;
+	
+	cur = list->head;
+	for (i = list->level - 1; i >= 0; i--)
+	{
+		while ((cur->next[i] != NULL) && (traversed + SKIP_LIST_SPAN(cur)[i] <= rank))
+		{
+			traversed += SKIP_LIST_SPAN(cur)[i];
+			cur = cur->next[i];
+		}
+		if (traversed == rank)
+			return cur;
+	}
+	
+	return NULL;
+}
+
+/**
+ * 按排名范围遍历,对排名在 [start, end] 内的节点按key从小到大调用fun.
+ * 先用O(log n)定位到排名start的节点,再沿第一层链表顺序访问.
+ * 
+ * @param list:跳表
+ * @param start:起始排名,从1开始
+ * @param end:结束排名,大于节点数时到最后一个节点
+ * @param fun:节点处理函数,返回非0时停止遍历; NULL时只计数
+ * @param param:传给fun的参数
+ * @return -1:跳表为空
+ *        >=0:访问的节点个数
+ */
+int skip_list_range_rank(struct skip_list *list, int start, int end, skip_list_visit_fun fun, void *param)
+{
+	struct skip_list_node *cur = NULL;
+	int n = 0;
+	
+	if (list == NULL)
+		return -1;
+	
+	if (start < 1)
+		start = 1;
+	if (end > list->num)
+		end = list->num;
+	
+	for (cur = skip_list_select(list, start); (cur != NULL) && (start + n <= end); cur = cur->next[0])
+	{
+		n++;
+		if ((fun != NULL) && (fun(list, cur, param) != 0))
+			break;
+	}
+	
+	return n;
+}
+#endif
+
+/**
+ * 插入跳表节点(key和value为int).
+ * 
+ * @return -1:跳表为空
+ *         -2:空间分配失败
+ *         -3:key已经存在
+ *          0:插入成功
+ */
+int skip_list_insert(struct skip_list *list, int key, int value)
+{
+	return skip_list_insert_key(list, &key, &value, sizeof(value));
+}
+
+/**
+ * 删除跳表节点(key和value为int).
+ * 
+ * @return -1:跳表为空 或 跳表节点数量为0
+ *         -3:key不存在
+ *          0:删除成功
+ */
+int skip_list_delete(struct skip_list *list, int key)
+{
+	return skip_list_delete_key(list, &key);
+}
+
+/**
+ * 修改跳表节点(key和value为int).
+ * 
+ * @return -1:跳表为空 或 跳表节点数量为0
+ *         -3:key不存在
+ *          0:修改成功
+ */
+int skip_list_modify(struct skip_list *list, int key, int value)
+{
+	return skip_list_modify_key(list, &key, &value, sizeof(value));
+}
+
+/**
+ * 查询跳表节点(key和value为int).
+ * 
+ * @return -1:跳表为空 或 跳表节点数量为0
+ *         -3:key不存在
+ *          0:查找成功
+ */
+int skip_list_search(struct skip_list *list, int key, int *value)
+{
+	void *data = NULL;
+	int ret = 0;
+	
+	if (value == NULL)
+		return -1;
+	
+	ret = skip_list_search_key(list, &key, &data, NULL);
+	if (ret == 0)
+	{
+		memcpy(value, data, sizeof(*value));
+	}
+	
+	return ret;
+}
+
 /**
  * 销毁跳表.
  * 
@@ -338,16 +1158,20 @@ int skip_list_destroy(struct skip_list *list)
 {
 	struct skip_list_node *cur = NULL;
 	
-	if (list == NULL && list->head == NULL)
+	if (list == NULL || list->head == NULL)
 		return -1;
 	
 	while((cur = list->head->next[0]) != NULL)
 	{
 		list->head->next[0] = cur->next[0];
-		SKIP_LIST_FREE(cur);
+		skip_list_node_free(list, cur);
 		cur = NULL;
 	}
 	
+	/*使用内存池时,节点随内存块一起释放*/
+	skip_list_chunk_free(list->chunks);
+	skip_list_chunk_free(list->spare);
+	
 	SKIP_LIST_FREE(list->head);
 	SKIP_LIST_FREE(list);
 	
@@ -407,5 +1231,303 @@ void skip_list_test(void)
 	skip_list_search(skip_list_t, 55, &skip_list_r[4]);
 }
 
+/*字符串key,value为变长数据保存在节点内*/
+struct skip_list *skip_list_key_t;
+char skip_list_key_r[5][16];
+void skip_list_key_sample(void)
+{
+	int i = 0, len = 0;
+	char key[16], value[16];
+	void *data = NULL;
+	
+	skip_list_key_t = skip_list_creat_key(5, SKIP_LIST_KEY_STR, NULL);
+	
+	/*插入数据,value按实际长度保存*/
+	for (i=0; i<5; i++)
+	{
+		sprintf(key, "key%d", i);
+		sprintf(value, "value%d", i * 100);
+		skip_list_insert_key(skip_list_key_t, key, value, strlen(value) + 1);
+	}
+	
+	/*修改数据,value长度变化时节点会被替换*/
+	skip_list_modify_key(skip_list_key_t, "key1", "v1", 3);
+	
+	/*删除数据*/
+	skip_list_delete_key(skip_list_key_t, "key2");
+	
+	for (i=0; i<5; i++)
+	{
+		memset(skip_list_key_r[i], 0, sizeof(skip_list_key_r[i]));
+		sprintf(key, "key%d", i);
+		if (skip_list_search_key(skip_list_key_t, key, &data, &len) == 0)
+		{
+			memcpy(skip_list_key_r[i], data, len);
+		}
+	}
+	
+	skip_list_destroy(skip_list_key_t);
+}
+
+/*按key范围遍历*/
+int skip_list_range_r[10];
+static int skip_list_range_visit(struct skip_list *list, struct skip_list_node *node, void *param)
+{
+	int *n = param;
+	
+	skip_list_range_r[(*n)++] = *(int *)node->value;
+	
+	return (*n >= 10);
+}
+
+void skip_list_range_sample(void)
+{
+	struct skip_list *list = NULL;
+	struct skip_list_node *node = NULL;
+	int i = 0, n = 0, min = 25, max = 75;
+	
+	list = skip_list_creat(8);
+	for (i=0; i<100; i+=5)
+	{
+		skip_list_insert(list, i, i * 10);
+	}
+	
+	/*25 <= key <= 75 的节点*/
+	n = 0;
+	skip_list_range(list, &min, &max, skip_list_range_visit, &n);
+	n = skip_list_count(list, &min, &max);
+	
+	/*从第一个不小于min的节点开始顺序遍历*/
+	for (node = skip_list_seek(list, &min), i = 0; (node != NULL) && (i < 10); node = skip_list_next(node), i++)
+	{
+		skip_list_range_r[i] = *(int *)node->key;
+	}
+	
+	skip_list_destroy(list);
+}
+
+#ifdef SKIP_LIST_USING_SPAN
+/*按排名访问,排行榜中按分数排名和取第i名*/
+int skip_list_rank_r[10];
+void skip_list_rank_sample(void)
+{
+	struct skip_list *list = NULL;
+	struct skip_list_node *node = NULL;
+	int i = 0, n = 0, key = 0;
+	
+	list = skip_list_creat(8);
+	for (i=0; i<100; i+=5)
+	{
+		skip_list_insert(list, i, i * 10);
+	}
+	skip_list_delete(list, 20);
+	
+	/*key 50的排名为10*/
+	key = 50;
+	skip_list_rank_r[0] = skip_list_rank(list, &key);
+	
+	/*第5名的key为25*/
+	node = skip_list_select(list, 5);
+	skip_list_rank_r[1] = (node != NULL) ? *(int *)node->key : -1;
+	
+	/*第3到第10名,共8个节点*/
+	n = skip_list_range_rank(list, 3, 10, NULL, NULL);
+	for (node = skip_list_select(list, 3), i = 2; (node != NULL) && (i < 2 + n); node = skip_list_next(node), i++)
+	{
+		skip_list_rank_r[i] = *(int *)node->key;
+	}
+	
+	skip_list_destroy(list);
+}
+#endif
+
+
+/*******************************************************************************************
+ *                                   内存申请次数测试
+ *******************************************************************************************/
+#define SKIP_LIST_BENCH_NUM  10000
+
+#ifdef SKIP_LIST_USING_ALLOC_COUNT
+unsigned long skip_list_alloc_count;
+#define SKIP_LIST_ALLOC_COUNT()  skip_list_alloc_count
+#else
+#define SKIP_LIST_ALLOC_COUNT()  0UL
+#endif
+
+/*
+ * 每种操作执行SKIP_LIST_BENCH_NUM次的内存申请次数和耗时(tick), [0]:插入 [1]:查找 [2]:删除
+ * 插入的申请次数应等于操作次数(只申请节点),查找和删除应为0;未定义SKIP_LIST_USING_ALLOC_COUNT时申请次数都为0
+ */
+unsigned long skip_list_bench_allocs[3];
+rt_tick_t skip_list_bench_ticks[3];
+
+void skip_list_alloc_bench(void)
+{
+	struct skip_list *list = NULL;
+	rt_tick_t start = 0;
+	unsigned long count = 0;
+	int i = 0, value = 0;
+	
+	list = skip_list_creat(SKIP_LIST_MAX_LEVEL);
+	if (list == NULL)
+		return;
+	
+	count = SKIP_LIST_ALLOC_COUNT();
+	start = rt_tick_get();
+	for (i=0; i<SKIP_LIST_BENCH_NUM; i++)
+	{
+		skip_list_insert(list, (i * 7919) % SKIP_LIST_BENCH_NUM, i);
+	}
+	skip_list_bench_ticks[0] = rt_tick_get() - start;
+	skip_list_bench_allocs[0] = SKIP_LIST_ALLOC_COUNT() - count;
+	
+	count = SKIP_LIST_ALLOC_COUNT();
+	start = rt_tick_get();
+	for (i=0; i<SKIP_LIST_BENCH_NUM; i++)
+	{
+		skip_list_search(list, i, &value);
+	}
+	skip_list_bench_ticks[1] = rt_tick_get() - start;
+	skip_list_bench_allocs[1] = SKIP_LIST_ALLOC_COUNT() - count;
+	
+	count = SKIP_LIST_ALLOC_COUNT();
+	start = rt_tick_get();
+	for (i=0; i<SKIP_LIST_BENCH_NUM; i++)
+	{
+		skip_list_delete(list, i);
+	}
+	skip_list_bench_ticks[2] = rt_tick_get() - start;
+	skip_list_bench_allocs[2] = SKIP_LIST_ALLOC_COUNT() - count;
+	
+	skip_list_destroy(list);
+}
+
 
+/*******************************************************************************************
+ *                                   批量构建性能对比
+ *******************************************************************************************/
+#define SKIP_LIST_BUILD_NUM  10000
 
+/*构建SKIP_LIST_BUILD_NUM个节点的耗时(tick), [0]:逐个插入 [1]:skip_list_build_sorted*/
+rt_tick_t skip_list_build_ticks[2];
+
+void skip_list_build_bench(void)
+{
+	struct skip_list *list = NULL;
+	int *data = NULL;
+	void **keys = NULL;
+	rt_tick_t start = 0;
+	int i = 0;
+	
+	data = (int *)SKIP_LIST_MALLOC(SKIP_LIST_BUILD_NUM * sizeof(int));
+	keys = (void **)SKIP_LIST_MALLOC(SKIP_LIST_BUILD_NUM * sizeof(void *));
+	if (data == NULL || keys == NULL)
+		goto _exit;
+	for (i=0; i<SKIP_LIST_BUILD_NUM; i++)
+	{
+		data[i] = i * 2;
+		keys[i] = &data[i];
+	}
+	
+	list = skip_list_creat(SKIP_LIST_MAX_LEVEL);
+	if (list != NULL)
+	{
+		start = rt_tick_get();
+		for (i=0; i<SKIP_LIST_BUILD_NUM; i++)
+		{
+			skip_list_insert(list, data[i], data[i]);
+		}
+		skip_list_build_ticks[0] = rt_tick_get() - start;
+		skip_list_destroy(list);
+	}
+	
+	list = skip_list_creat(SKIP_LIST_MAX_LEVEL);
+	if (list != NULL)
+	{
+		start = rt_tick_get();
+		skip_list_build_sorted(list, keys, keys, SKIP_LIST_BUILD_NUM, sizeof(int));
+		skip_list_build_ticks[1] = rt_tick_get() - start;
+		skip_list_destroy(list);
+	}
+	
+_exit:
+	if (data != NULL)
+	{
+		SKIP_LIST_FREE(data);
+	}
+	if (keys != NULL)
+	{
+		SKIP_LIST_FREE(keys);
+	}
+}
+
+
+/*******************************************************************************************
+ *                                   内存池顺序遍历对比
+ *******************************************************************************************/
+#define SKIP_LIST_ARENA_NUM    100000
+#define SKIP_LIST_ARENA_LOOP   20
+
+/*
+ * 乱序插入SKIP_LIST_ARENA_NUM个节点后顺序遍历SKIP_LIST_ARENA_LOOP次的耗时(tick)和插入的内存申请次数
+ * [0]:每个节点单独申请 [1]:内存池 [2]:内存池整理后
+ */
+rt_tick_t skip_list_arena_ticks[3];
+unsigned long skip_list_arena_allocs[3];
+
+static int skip_list_arena_visit(struct skip_list *list, struct skip_list_node *node, void *param)
+{
+	*(unsigned int *)param += *(int *)node->value;
+	
+	return 0;
+}
+
+void skip_list_arena_bench(void)
+{
+	struct skip_list *list = NULL;
+	rt_tick_t start = 0;
+	unsigned long count = 0;
+	unsigned int sum = 0;
+	int i = 0, j = 0;
+	
+	for (j = 0; j < 2; j++)
+	{
+		list = skip_list_creat(SKIP_LIST_MAX_LEVEL);
+		if (list == NULL)
+			return;
+		if (j == 1)
+		{
+			skip_list_set_arena(list, 0);
+		}
+		
+		count = SKIP_LIST_ALLOC_COUNT();
+		for (i=0; i<SKIP_LIST_ARENA_NUM; i++)
+		{
+			skip_list_insert(list, (i * 7919) % SKIP_LIST_ARENA_NUM, i);
+		}
+		skip_list_arena_allocs[j] = SKIP_LIST_ALLOC_COUNT() - count;
+		
+		start = rt_tick_get();
+		for (i=0; i<SKIP_LIST_ARENA_LOOP; i++)
+		{
+			skip_list_range(list, NULL, NULL, skip_list_arena_visit, &sum);
+		}
+		skip_list_arena_ticks[j] = rt_tick_get() - start;
+		
+		if (j == 1)
+		{
+			count = SKIP_LIST_ALLOC_COUNT();
+			skip_list_compact(list);
+			skip_list_arena_allocs[2] = SKIP_LIST_ALLOC_COUNT() - count;
+			
+			start = rt_tick_get();
+			for (i=0; i<SKIP_LIST_ARENA_LOOP; i++)
+			{
+				skip_list_range(list, NULL, NULL, skip_list_arena_visit, &sum);
+			}
+			skip_list_arena_ticks[2] = rt_tick_get() - start;
+		}
+		
+		skip_list_destroy(list);
+	}
+}
@@ -4,6 +4,13 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-12-24     denghengli   the first version
+ * 2026-10-17     denghengli   generic keys (binary/string/pointer) with inline values
+ * 2026-10-17     denghengli   ordered iteration, seek and range scan
+ * 2026-10-17     denghengli   update vectors on the stack, no allocation in search/delete
+ * 2026-10-17     denghengli   per-list xorshift64* level generator with configurable promotion probability
+ * 2026-10-17     denghengli   linear-time bulk build and sorted append
+ * 2026-10-17     denghengli   span widths for O(log n) rank and select (SKIP_LIST_USING_SPAN)
+ * 2026-10-17     denghengli   node arena and key-order compaction
  */
 
 #ifndef __ALGO_SKIP_LIST_H__
@@ -14,25 +21,140 @@
 #include <string.h>
 #include <rtthread.h>
 
+/* 定义后统计内存申请次数,用于确认插入只申请节点,查找和删除不申请内存;计数不是原子操作,只在测试时打开 */
+//#define SKIP_LIST_USING_ALLOC_COUNT
+
+#ifdef SKIP_LIST_USING_ALLOC_COUNT
+extern unsigned long skip_list_alloc_count;
+#define SKIP_LIST_MALLOC(size)   (skip_list_alloc_count++, rt_malloc(size));
+#else
 #define SKIP_LIST_MALLOC(size)   rt_malloc(size);
+#endif
 #define SKIP_LIST_CALLOC(n,size) rt_calloc(n,size);
 #define SKIP_LIST_FREE(p)        rt_free(p);
 
+#define SKIP_LIST_MAX_LEVEL      32 /*最大层数,插入/删除时各层前驱节点数组在栈上按该大小分配*/
+
+/*节点晋升到上一层的概率,以65536为1*/
+#define SKIP_LIST_P_1_2          32768 /*1/2,每层节点数减半*/
+#define SKIP_LIST_P_1_4          16384 /*1/4,节点平均层数少,内存占用小,查找比较次数略多*/
+#define SKIP_LIST_P_1_E          24109 /*1/e,理论上查找比较次数最少*/
+#define SKIP_LIST_P              SKIP_LIST_P_1_2 /*默认晋升概率*/
+
+/*64位数低位连续0的个数,x不为0,编译器不支持时使用循环实现*/
+#if defined(__GNUC__)
+#define SKIP_LIST_CTZ64(x)       __builtin_ctzll(x)
+#endif
+
+#define SKIP_LIST_KEY_PTR        0  /*key只保存指针,key的内存由调用者管理,必须指定比较函数*/
+#define SKIP_LIST_KEY_STR        -1 /*key为字符串,复制到节点内*/
+
+/*定义后节点每层索引记录跨越的节点数(span),支持按排名查找和排名范围遍历,每个节点每层多占用一个int*/
+#define SKIP_LIST_USING_SPAN
+
+#ifdef SKIP_LIST_USING_SPAN
+#define SKIP_LIST_SPAN(node)       ((int *)&(node)->next[(node)->max_level]) /*节点各层的span,在next数组之后*/
+#define SKIP_LIST_SPAN_SIZE(level) ((level) * sizeof(int))
+#else
+#define SKIP_LIST_SPAN_SIZE(level) 0
+#endif
+
+/*节点内key/value数据的对齐*/
+#define SKIP_LIST_ALIGN(n)       (((n) + 7) & ~7)
+
+/*
+ * 节点内存池(skip_list_set_arena后使用).节点从连续的内存块中分配,删除的节点按8字节大小分级放入空闲链表再次使用,
+ * 超过SKIP_LIST_ARENA_MAX字节的节点仍单独申请.
+ */
+#define SKIP_LIST_ARENA_CLASSES  32                              /*空闲链表的分级数*/
+#define SKIP_LIST_ARENA_MAX      (SKIP_LIST_ARENA_CLASSES * 8)   /*从内存池分配的最大节点字节数*/
+#define SKIP_LIST_ARENA_CHUNK    4096                            /*默认内存块大小*/
+
+struct skip_list;
+struct skip_list_node;
+
+/* 
+ * key比较, key_cmp:传入的要比较的key, key_becmp:跳表中被比较的key
+ * 返回值 > 0 : key_cmp > key_becmp
+ * 返回值 = 0 : key_cmp = key_becmp
+ * 返回值 < 0 : key_cmp < key_becmp
+ */
+typedef int (*skip_list_keycmp)(struct skip_list *list, const void *key_cmp, const void *key_becmp);
+/* 范围遍历时的节点处理函数,返回非0时停止遍历 */
+typedef int (*skip_list_visit_fun)(struct skip_list *list, struct skip_list_node *node, void *param);
+
+/*
+ * 节点和各层的next、key、value数据在一次申请的连续空间中:
+ * | struct skip_list_node | next[max_level] | span[max_level](SKIP_LIST_USING_SPAN) | key(keysize>0或字符串时) | value(valuelen>0时) |
+ * span[i]为第i层从本节点到next[i]在第一层上跨越的节点数,next[i]为空时为到表尾的节点数
+ */
 struct skip_list_node
 {
-	int key;       /*key是唯一的*/
-	int value;     /*存储的内容*/
+	void *key;     /*key是唯一的,指向节点内的key数据或调用者的key*/
+	void *value;   /*存储的内容,valuelen>0时指向节点内的value数据,否则为调用者传入的指针*/
+	int valuelen;  /*节点内value数据的字节数,0表示只保存指针*/
 	int max_level; /*当前节点最大层数*/
 	struct skip_list_node *next[];/*柔性数组,根据该节点层数的不同指向大小不同的数组*/
 };
 
+/*内存池的内存块,节点数据紧跟在后面*/
+struct skip_list_chunk
+{
+	struct skip_list_chunk *next;
+};
+
 struct skip_list
 {
-	int level; /*跳表的索引层数*/
-	int num;   /*节点数目*/
+	int level;   /*跳表的索引层数*/
+	int num;     /*节点数目*/
+	int keysize; /*>0:key为keysize字节的数据,复制到节点内; SKIP_LIST_KEY_STR:字符串; SKIP_LIST_KEY_PTR:只保存指针*/
+	skip_list_keycmp keycmp; /*key比较*/
 	struct skip_list_node *head;
+	
+	/*随机层数*/
+	unsigned long long rng; /*xorshift64*随机数状态,每个跳表独立*/
+	int p;                  /*晋升概率,以65536为1*/
+	int p_bits;             /*p为1/2^p_bits时的p_bits,0表示p不是2的幂分之一*/
+	
+	/*节点内存池,chunk_size为0时每个节点单独申请*/
+	int chunk_size;                        /*内存块大小*/
+	int arena_left;                        /*当前内存块剩余的字节数*/
+	char *arena_cur;                       /*当前内存块中未使用空间的起始地址*/
+	struct skip_list_chunk *chunks;        /*已使用的内存块*/
+	struct skip_list_chunk *spare;         /*整理时预先申请的内存块*/
+	void *free_nodes[SKIP_LIST_ARENA_CLASSES]; /*删除的节点,按大小分级*/
 };
 
+extern struct skip_list* skip_list_creat_key(int max_level, int keysize, skip_list_keycmp keycmp);
+extern int skip_list_set_p(struct skip_list *list, int p);
+extern int skip_list_insert_key(struct skip_list *list, const void *key, const void *value, int valuelen);
+extern int skip_list_delete_key(struct skip_list *list, const void *key);
+extern int skip_list_modify_key(struct skip_list *list, const void *key, const void *value, int valuelen);
+extern int skip_list_search_key(struct skip_list *list, const void *key, void **value, int *valuelen);
+
+/*节点内存池,set_arena只能在跳表为空时调用*/
+extern int skip_list_set_arena(struct skip_list *list, int chunk_size);
+extern int skip_list_compact(struct skip_list *list);
+
+/*从有序数据批量构建,keys必须严格递增*/
+extern int skip_list_build_sorted (struct skip_list *list, void **keys, void **values, int num, int valuelen);
+extern int skip_list_append_sorted(struct skip_list *list, void **keys, void **values, int num, int valuelen);
+
+/*有序遍历,遍历过程中不能插入/删除节点*/
+extern struct skip_list_node* skip_list_first(struct skip_list *list);
+extern struct skip_list_node* skip_list_next (struct skip_list_node *node);
+extern struct skip_list_node* skip_list_seek (struct skip_list *list, const void *key);
+extern int skip_list_range(struct skip_list *list, const void *min, const void *max, skip_list_visit_fun fun, void *param);
+extern int skip_list_count(struct skip_list *list, const void *min, const void *max);
+
+#ifdef SKIP_LIST_USING_SPAN
+/*按排名访问,排名从1开始*/
+extern int skip_list_rank(struct skip_list *list, const void *key);
+extern struct skip_list_node* skip_list_select(struct skip_list *list, int rank);
+extern int skip_list_range_rank(struct skip_list *list, int start, int end, skip_list_visit_fun fun, void *param);
+#endif
+
+/*key和value为int的跳表*/
 extern struct skip_list* skip_list_creat(int max_level);
 extern int skip_list_insert (struct skip_list *list, int key, int value);
 extern int skip_list_delete (struct skip_list *list, int key);
@@ -41,6 +163,14 @@ extern int skip_list_search (struct skip_list *list, int key, int *value);
 extern int skip_list_destroy(struct skip_list *list);
 
 extern void skip_list_test(void);
+extern void skip_list_key_sample(void);
+extern void skip_list_range_sample(void);
+#ifdef SKIP_LIST_USING_SPAN
+extern void skip_list_rank_sample(void);
+#endif
+extern void skip_list_alloc_bench(void);
+extern void skip_list_build_bench(void);
+extern void skip_list_arena_bench(void);
 
 #endif
 
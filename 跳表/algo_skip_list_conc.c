@@ -0,0 +1,727 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   per-thread epoch counters and level seeds
+ */
+
+#include "algo_skip_list_conc.h"
+
+/**
+ * 默认key比较函数.
+ */
+static int skip_conc_keycmp_bytes(struct skip_list_conc *list, const void *key_cmp, const void *key_becmp)
+{
+	return memcmp(key_cmp, key_becmp, list->keysize);
+}
+
+static int skip_conc_keycmp_str(struct skip_list_conc *list, const void *key_cmp, const void *key_becmp)
+{
+	return strcmp(key_cmp, key_becmp);
+}
+
+/**
+ * 动态申请跳表节点,各层next清零,key按keysize复制到节点内.
+ *
+ * @return NULL:内存申请失败
+ *        !NULL:节点创建成功
+ */
+static struct skip_conc_node* skip_conc_node_creat(struct skip_list_conc *list, int level, const void *key, void *value)
+{
+	struct skip_conc_node *node = NULL;
+	int keylen = 0, key_offset = 0;
+
+	if (key != NULL)
+	{
+		if (list->keysize > 0)
+			keylen = list->keysize;
+		else if (list->keysize == SKIP_LIST_KEY_STR)
+			keylen = strlen(key) + 1;
+	}
+
+	key_offset = SKIP_LIST_ALIGN(sizeof(*node) + level * sizeof(node));
+	node = (struct skip_conc_node *)SKIP_CONC_MALLOC(key_offset + keylen);
+	if (node == NULL)
+		return NULL;
+
+	memset(node, 0, sizeof(*node) + level * sizeof(node));
+	node->max_level = level;
+	node->value = value;
+	node->refs = 2;
+	if (keylen > 0)
+	{
+		node->key = (char *)node + key_offset;
+		memcpy(node->key, key, keylen);
+	}
+	else
+	{
+		node->key = (void *)key;
+	}
+
+	return node;
+}
+
+/**
+ * 创建并发跳表.
+ *
+ * @param max_level:跳表最大层数,不超过SKIP_CONC_MAX_LEVEL
+ * @param keysize:>0:key为keysize字节的数据; SKIP_LIST_KEY_STR:key为字符串; SKIP_LIST_KEY_PTR:只保存key指针
+ * @param keycmp:key比较函数,NULL时数据按memcmp、字符串按strcmp比较
+ * @return NULL:创建失败
+ *        !NULL:创建成功
+ */
+struct skip_list_conc* skip_list_conc_creat(int max_level, int keysize, skip_conc_keycmp keycmp)
+{
+	struct skip_list_conc *list = NULL;
+	int i = 0;
+
+	if (max_level <= 0 || max_level > SKIP_CONC_MAX_LEVEL || keysize < SKIP_LIST_KEY_STR)
+		return NULL;
+
+	if (keycmp == NULL)
+	{
+		if (keysize == SKIP_LIST_KEY_PTR)
+			return NULL;
+		keycmp = (keysize > 0) ? skip_conc_keycmp_bytes : skip_conc_keycmp_str;
+	}
+
+	list = (struct skip_list_conc *)SKIP_CONC_MALLOC(sizeof(*list));
+	if (list == NULL)
+		return NULL;
+	memset(list, 0, sizeof(*list));
+
+	list->level = 1;
+	list->keysize = keysize;
+	list->keycmp = keycmp;
+	for (i = 0; i < SKIP_CONC_SLOT_NUM; i++)
+	{
+		list->slots[i].seed = ((rt_tick_get() + i) * 0x9E3779B9u) | 1;
+	}
+	list->head = skip_conc_node_creat(list, max_level, NULL, NULL);
+	list->reclaim_lock = rt_mutex_create("sconc", RT_IPC_FLAG_PRIO);
+	if (list->head == NULL || list->reclaim_lock == NULL)
+	{
+		if (list->head != NULL)
+		{
+			SKIP_CONC_FREE(list->head);
+		}
+		if (list->reclaim_lock != NULL)
+			rt_mutex_delete(list->reclaim_lock);
+		SKIP_CONC_FREE(list);
+		return NULL;
+	}
+
+	return list;
+}
+
+/**
+ * 当前线程使用的线程槽,按线程控制块地址分散,不同线程大多落在不同的槽中.
+ */
+static int skip_conc_slot(void)
+{
+	unsigned int id = (unsigned int)((unsigned long)rt_thread_self() >> 4);
+
+	return ((id * 0x9E3779B9u) >> 16) & (SKIP_CONC_SLOT_NUM - 1);
+}
+
+/**
+ * 进入读者区间.先登记到当前纪元的线程计数中,登记后纪元已经改变则重新登记,
+ * 保证回收线程要么看到本线程的计数,要么本线程看到新的纪元(此时被回收的节点已经不可达).
+ * 插入/删除/修改/查找内部都会进入该区间,计数在本线程的线程槽中,线程之间不会竞争同一个缓存行.
+ *
+ * @return 线程所在的线程槽和纪元,退出时传给skip_list_conc_read_unlock
+ */
+int skip_list_conc_read_lock(struct skip_list_conc *list)
+{
+	int idx = skip_conc_slot();
+	struct skip_conc_slot *slot = &list->slots[idx];
+	unsigned int epoch = 0;
+
+	while (1)
+	{
+		epoch = SKIP_CONC_LOAD_SC(&list->epoch);
+		SKIP_CONC_ADD(&slot->threads[epoch & 1], 1);
+		if (SKIP_CONC_LOAD_SC(&list->epoch) == epoch)
+			return (idx << 1) | (epoch & 1);
+		SKIP_CONC_ADD(&slot->threads[epoch & 1], -1);
+	}
+}
+
+/**
+ * 退出读者区间.
+ */
+void skip_list_conc_read_unlock(struct skip_list_conc *list, int idx)
+{
+	SKIP_CONC_ADD(&list->slots[idx >> 1].threads[idx & 1], -1);
+}
+
+/**
+ * 释放待回收的节点.
+ */
+static void skip_conc_free_retired(struct skip_conc_node *node)
+{
+	struct skip_conc_node *next = NULL;
+
+	while (node != NULL)
+	{
+		next = node->retire_next;
+		SKIP_CONC_FREE(node);
+		node = next;
+	}
+}
+
+/**
+ * 尝试推进纪元.纪元从e推进到e+1的条件是没有纪元e-1的线程,此时纪元e-1内摘除的节点已经没有线程可以访问.
+ * 只尝试获取锁,其他线程正在回收时直接返回,留到下次删除时再回收.
+ */
+static void skip_conc_reclaim(struct skip_list_conc *list)
+{
+	struct skip_conc_node *nodes = NULL;
+	int i = 0, old = 0;
+
+	if (rt_mutex_take(list->reclaim_lock, 0) != RT_EOK)
+		return;
+
+	old = (list->epoch + 1) & 1;
+	/*保证前面摘除节点的写操作先于读取线程计数*/
+	SKIP_CONC_FENCE();
+	for (i = 0; i < SKIP_CONC_SLOT_NUM; i++)
+	{
+		if (SKIP_CONC_LOAD_SC(&list->slots[i].threads[old]) != 0)
+		{
+			rt_mutex_release(list->reclaim_lock);
+			return;
+		}
+	}
+
+	nodes = SKIP_CONC_XCHG(&list->retired[old], NULL);
+	SKIP_CONC_ADD(&list->epoch, 1);
+	rt_mutex_release(list->reclaim_lock);
+
+	skip_conc_free_retired(nodes);
+}
+
+/**
+ * 释放节点的一个引用,插入线程和删除线程都释放后节点已经从各层摘除,放入当前纪元的待回收链表.
+ * 调用者仍在纪元区间内,当前纪元最多比它登记时的纪元大1,两种情况下该链表都要等它退出后才会被回收.
+ */
+static void skip_conc_node_put(struct skip_list_conc *list, struct skip_conc_node *node)
+{
+	struct skip_conc_node *head = NULL;
+	int cur = 0;
+
+	if (SKIP_CONC_ADD(&node->refs, -1) != 0)
+		return;
+
+	/*保证摘除节点的写操作先于读取纪元*/
+	SKIP_CONC_FENCE();
+	cur = SKIP_CONC_LOAD_SC(&list->epoch) & 1;
+	head = SKIP_CONC_LOAD(&list->retired[cur]);
+	do
+	{
+		node->retire_next = head;
+	} while (!SKIP_CONC_CAS(&list->retired[cur], &head, node));
+
+	skip_conc_reclaim(list);
+}
+
+/**
+ * 随机产生插入元素的索引层数,每层晋升的概率为1/2.
+ * 每个线程使用自己线程槽中的xorshift32种子,不做原子读改写;
+ * 同一个槽的线程同时插入时可能得到相同的层数,不影响正确性.
+ */
+static int skip_conc_level(struct skip_list_conc *list)
+{
+	struct skip_conc_slot *slot = &list->slots[skip_conc_slot()];
+	unsigned int r = SKIP_CONC_LOAD_RLX(&slot->seed);
+	int level = 1;
+
+	r ^= r << 13;
+	r ^= r >> 17;
+	r ^= r << 5;
+	SKIP_CONC_STORE_RLX(&slot->seed, r);
+
+	while ((r & 1) && (level < list->head->max_level))
+	{
+		level++;
+		r >>= 1;
+	}
+
+	return level;
+}
+
+/**
+ * 逐层查找key的各层前驱和后继节点,并摘除路径上已标记删除的节点.
+ * preds[i]为第i层最后一个key小于查找key的节点,succs[i]为其后第一个未标记的节点.
+ *
+ * @param top:至少从该层开始查找
+ * @return 1:succs[0]的key等于查找key
+ *         0:key不存在
+ */
+static int skip_conc_find(struct skip_list_conc *list, const void *key, int top, struct skip_conc_node **preds, struct skip_conc_node **succs)
+{
+	struct skip_conc_node *pred = NULL, *cur = NULL, *succ = NULL;
+	int i = 0, level = 0;
+
+	level = SKIP_CONC_LOAD(&list->level);
+	if (level < top)
+		level = top;
+
+_retry:
+	pred = list->head;
+	for (i = list->head->max_level - 1; i >= level; i--)
+	{
+		preds[i] = list->head;
+		succs[i] = NULL;
+	}
+	for (i = level - 1; i >= 0; i--)
+	{
+		cur = SKIP_CONC_UNMARK(SKIP_CONC_LOAD(&pred->next[i]));
+		while (cur != NULL)
+		{
+			succ = SKIP_CONC_LOAD(&cur->next[i]);
+			if (SKIP_CONC_IS_MARKED(succ))
+			{
+				/*cur已标记删除,从该层摘除.pred被删除或pred->next已改变时CAS失败,重新查找*/
+				if (!SKIP_CONC_CAS(&pred->next[i], &cur, SKIP_CONC_UNMARK(succ)))
+					goto _retry;
+				cur = SKIP_CONC_UNMARK(succ);
+				continue;
+			}
+			if (list->keycmp(list, key, cur->key) <= 0)
+				break;
+			pred = cur;
+			cur = succ;
+		}
+		preds[i] = pred;
+		succs[i] = cur;
+	}
+
+	return (succs[0] != NULL) && (list->keycmp(list, key, succs[0]->key) == 0);
+}
+
+/**
+ * 把已标记删除的节点从各层中摘除.从最高层开始逐层定位,node所在的层中遇到node时摘除.
+ * 摘除期间可能插入了key相同的新节点,新旧节点在各层的先后顺序不确定,
+ * 所以要遍历完每层中key相等的所有节点,不能在第一个key相等的节点处停止.
+ */
+static void skip_conc_unlink(struct skip_list_conc *list, struct skip_conc_node *node)
+{
+	struct skip_conc_node *start = NULL, *pred = NULL, *cur = NULL, *succ = NULL;
+	int i = 0, res = 0;
+
+_retry:
+	start = list->head;
+	for (i = SKIP_CONC_LOAD(&list->level) - 1; i >= 0; i--)
+	{
+		pred = start;
+		cur = SKIP_CONC_UNMARK(SKIP_CONC_LOAD(&pred->next[i]));
+		while (cur != NULL)
+		{
+			succ = SKIP_CONC_LOAD(&cur->next[i]);
+			if (SKIP_CONC_IS_MARKED(succ))
+			{
+				if (!SKIP_CONC_CAS(&pred->next[i], &cur, SKIP_CONC_UNMARK(succ)))
+					goto _retry;
+				cur = SKIP_CONC_UNMARK(succ);
+				continue;
+			}
+			res = list->keycmp(list, node->key, cur->key);
+			if (res < 0)
+				break;
+			if (res > 0)
+				start = cur; /*下一层从最后一个key小于node的节点开始*/
+			pred = cur;
+			cur = succ;
+		}
+	}
+}
+
+/**
+ * 插入跳表节点.
+ *
+ * @param list:跳表
+ * @param key:按创建时的keysize复制到节点内,或只保存指针
+ * @param value:节点数据指针
+ * @return -1:跳表为空
+ *         -2:空间分配失败
+ *         -3:key已经存在
+ *          0:插入成功
+ */
+int skip_list_conc_insert(struct skip_list_conc *list, const void *key, void *value)
+{
+	struct skip_conc_node *preds[SKIP_CONC_MAX_LEVEL], *succs[SKIP_CONC_MAX_LEVEL];
+	struct skip_conc_node *node = NULL, *next = NULL;
+	int i = 0, level = 0, cur_level = 0, idx = 0;
+
+	if (list == NULL || key == NULL)
+		return -1;
+
+	level = skip_conc_level(list);
+	node = skip_conc_node_creat(list, level, key, value);
+	if (node == NULL)
+		return -2;
+
+	/*先提高层数,其他线程查找时才会从新的层开始*/
+	cur_level = SKIP_CONC_LOAD(&list->level);
+	while ((cur_level < level) && !SKIP_CONC_CAS(&list->level, &cur_level, level))
+		;
+
+	idx = skip_list_conc_read_lock(list);
+
+	/*链接第0层,成功即插入成功*/
+	while (1)
+	{
+		if (skip_conc_find(list, node->key, level, preds, succs))
+		{
+			skip_list_conc_read_unlock(list, idx);
+			SKIP_CONC_FREE(node);
+			return -3;
+		}
+		for (i = 0; i < level; i++)
+		{
+			node->next[i] = succs[i];
+		}
+		if (SKIP_CONC_CAS(&preds[0]->next[0], &succs[0], node))
+			break;
+	}
+	SKIP_CONC_ADD(&list->num, 1);
+
+	/*自底向上链接其他层,节点被删除(next已标记)时停止*/
+	for (i = 1; i < level; i++)
+	{
+		while (1)
+		{
+			next = SKIP_CONC_LOAD(&node->next[i]);
+			if (SKIP_CONC_IS_MARKED(next))
+				goto _done;
+			if ((next != succs[i]) && !SKIP_CONC_CAS(&node->next[i], &next, succs[i]))
+				goto _done;
+			if (SKIP_CONC_CAS(&preds[i]->next[i], &succs[i], node))
+				break;
+			skip_conc_find(list, node->key, level, preds, succs);
+			/*查找结果中第0层已经不是node,说明node已被删除*/
+			if (succs[0] != node)
+				goto _done;
+		}
+	}
+
+_done:
+	/*链接过程中node被删除,删除线程的摘除可能早于这里的链接,需要再摘除一次*/
+	if (SKIP_CONC_IS_MARKED(SKIP_CONC_LOAD_SC(&node->next[0])))
+		skip_conc_unlink(list, node);
+	skip_conc_node_put(list, node);
+
+	skip_list_conc_read_unlock(list, idx);
+	return 0;
+}
+
+/**
+ * 删除跳表节点.
+ *
+ * @param list:跳表
+ * @param key:
+ * @return -1:跳表为空
+ *         -3:key不存在
+ *          0:删除成功
+ */
+int skip_list_conc_delete(struct skip_list_conc *list, const void *key)
+{
+	struct skip_conc_node *preds[SKIP_CONC_MAX_LEVEL], *succs[SKIP_CONC_MAX_LEVEL];
+	struct skip_conc_node *node = NULL, *next = NULL;
+	int i = 0, idx = 0, ret = -3;
+
+	if (list == NULL || key == NULL)
+		return -1;
+
+	idx = skip_list_conc_read_lock(list);
+
+	if (skip_conc_find(list, key, 0, preds, succs))
+	{
+		node = succs[0];
+
+		/*自顶向下标记第1层以上的next*/
+		for (i = node->max_level - 1; i >= 1; i--)
+		{
+			next = SKIP_CONC_LOAD(&node->next[i]);
+			while (!SKIP_CONC_IS_MARKED(next) && !SKIP_CONC_CAS(&node->next[i], &next, SKIP_CONC_MARK(next)))
+				;
+		}
+
+		/*标记第0层,只有一个线程能成功*/
+		next = SKIP_CONC_LOAD(&node->next[0]);
+		while (!SKIP_CONC_IS_MARKED(next))
+		{
+			if (SKIP_CONC_CAS(&node->next[0], &next, SKIP_CONC_MARK(next)))
+			{
+				SKIP_CONC_ADD(&list->num, -1);
+				skip_conc_unlink(list, node);
+				skip_conc_node_put(list, node);
+				ret = 0;
+				break;
+			}
+		}
+	}
+
+	skip_list_conc_read_unlock(list, idx);
+	return ret;
+}
+
+/**
+ * 查找key所在的节点,不修改跳表,跳过已标记删除的节点.
+ * 需要在纪元区间内调用.
+ */
+static struct skip_conc_node *skip_conc_search(struct skip_list_conc *list, const void *key)
+{
+	struct skip_conc_node *pred = NULL, *cur = NULL, *succ = NULL;
+	int i = 0, res = 0;
+
+	pred = list->head;
+	for (i = SKIP_CONC_LOAD(&list->level) - 1; i >= 0; i--)
+	{
+		cur = SKIP_CONC_UNMARK(SKIP_CONC_LOAD(&pred->next[i]));
+		while (cur != NULL)
+		{
+			succ = SKIP_CONC_LOAD(&cur->next[i]);
+			if (SKIP_CONC_IS_MARKED(succ))
+			{
+				cur = SKIP_CONC_UNMARK(succ);
+				continue;
+			}
+			res = list->keycmp(list, key, cur->key);
+			if (res == 0)
+				return SKIP_CONC_IS_MARKED(SKIP_CONC_LOAD(&cur->next[0])) ? NULL : cur;
+			if (res < 0)
+				break;
+			pred = cur;
+			cur = succ;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * 修改key对应的value.
+ *
+ * @return -1:跳表为空
+ *         -3:key不存在
+ *          0:修改成功
+ */
+int skip_list_conc_modify(struct skip_list_conc *list, const void *key, void *value)
+{
+	struct skip_conc_node *node = NULL;
+	int idx = 0;
+
+	if (list == NULL || key == NULL)
+		return -1;
+
+	idx = skip_list_conc_read_lock(list);
+	node = skip_conc_search(list, key);
+	if (node != NULL)
+	{
+		SKIP_CONC_STORE(&node->value, value);
+	}
+	skip_list_conc_read_unlock(list, idx);
+
+	return (node != NULL) ? 0 : -3;
+}
+
+/**
+ * 查询key是否在跳表中,存在返回value.
+ *
+ * @param value:返回节点数据指针,不需要时为NULL
+ * @return -1:跳表为空
+ *         -3:key不存在
+ *          0:查找成功
+ */
+int skip_list_conc_search(struct skip_list_conc *list, const void *key, void **value)
+{
+	struct skip_conc_node *node = NULL;
+	int idx = 0;
+
+	if (list == NULL || key == NULL)
+		return -1;
+
+	idx = skip_list_conc_read_lock(list);
+	node = skip_conc_search(list, key);
+	if (node != NULL && value != NULL)
+	{
+		*value = SKIP_CONC_LOAD(&node->value);
+	}
+	skip_list_conc_read_unlock(list, idx);
+
+	return (node != NULL) ? 0 : -3;
+}
+
+/**
+ * 销毁跳表.调用时不能有其他线程访问.
+ *
+ * @return -1:跳表为空
+ *          0:成功
+ */
+int skip_list_conc_destroy(struct skip_list_conc *list)
+{
+	struct skip_conc_node *cur = NULL, *next = NULL;
+
+	if (list == NULL)
+		return -1;
+
+	/*没有线程访问时删除都已完成,第0层上都是未标记的节点,已摘除的节点都在待回收链表中*/
+	cur = list->head->next[0];
+	while (cur != NULL)
+	{
+		next = cur->next[0];
+		SKIP_CONC_FREE(cur);
+		cur = next;
+	}
+
+	skip_conc_free_retired(list->retired[0]);
+	skip_conc_free_retired(list->retired[1]);
+
+	rt_mutex_delete(list->reclaim_lock);
+	SKIP_CONC_FREE(list->head);
+	SKIP_CONC_FREE(list);
+
+	return 0;
+}
+
+
+/*******************************************************************************************
+ *                                   多线程扩展性测试
+ *******************************************************************************************/
+#define SKIP_CONC_BENCH_KEYS         65536
+#define SKIP_CONC_BENCH_OPS          100000  /*每个线程的操作次数,80%查找 10%插入 10%删除*/
+#define SKIP_CONC_BENCH_MAX_THREADS  16
+#define SKIP_CONC_BENCH_STACK        4096    /*测试线程栈大小,查找路径在栈上保存两个SKIP_CONC_MAX_LEVEL大小的指针数组*/
+
+static unsigned int *sconc_bench_keys;
+static int sconc_bench_done;
+static struct skip_list_conc *sconc_bench_list;
+static struct skip_list *sconc_bench_global_list;
+static rt_mutex_t sconc_bench_global_lock;
+
+/*
+ * 线程数为1到thread_num时完成全部操作的耗时(tick),
+ * [n-1][0]:n个线程 skip_list + 全局互斥锁  [n-1][1]:n个线程 skip_list_conc
+ */
+rt_tick_t skip_conc_bench_ticks[SKIP_CONC_BENCH_MAX_THREADS][2];
+
+static void sconc_bench_entry(void *param)
+{
+	unsigned int r = (unsigned int)(unsigned long)param * 2654435761u + 1;
+	unsigned int *key = NULL;
+	int i = 0, op = 0;
+
+	for (i = 0; i < SKIP_CONC_BENCH_OPS; i++)
+	{
+		r ^= r << 13;
+		r ^= r >> 17;
+		r ^= r << 5;
+		key = &sconc_bench_keys[r % SKIP_CONC_BENCH_KEYS];
+		op = (r >> 24) % 10;
+
+		if (sconc_bench_list != NULL)
+		{
+			if (op < 8)
+				skip_list_conc_search(sconc_bench_list, key, NULL);
+			else if (op == 8)
+				skip_list_conc_insert(sconc_bench_list, key, key);
+			else
+				skip_list_conc_delete(sconc_bench_list, key);
+		}
+		else
+		{
+			rt_mutex_take(sconc_bench_global_lock, RT_WAITING_FOREVER);
+			if (op < 8)
+				skip_list_search_key(sconc_bench_global_list, key, NULL, NULL);
+			else if (op == 8)
+				skip_list_insert_key(sconc_bench_global_list, key, key, 0);
+			else
+				skip_list_delete_key(sconc_bench_global_list, key);
+			rt_mutex_release(sconc_bench_global_lock);
+		}
+	}
+
+	SKIP_CONC_ADD(&sconc_bench_done, 1);
+}
+
+static rt_tick_t sconc_bench_run(int thread_num)
+{
+	rt_thread_t thread = NULL;
+	rt_tick_t start = 0;
+	int i = 0;
+
+	sconc_bench_done = 0;
+	start = rt_tick_get();
+	for (i = 0; i < thread_num; i++)
+	{
+		thread = rt_thread_create("sconc", sconc_bench_entry, (void *)(unsigned long)(i + 1), SKIP_CONC_BENCH_STACK, 20, 10);
+		if (thread == NULL)
+		{
+			SKIP_CONC_ADD(&sconc_bench_done, 1);
+			continue;
+		}
+		rt_thread_startup(thread);
+	}
+
+	while (SKIP_CONC_LOAD_SC(&sconc_bench_done) < thread_num)
+	{
+		rt_thread_mdelay(1);
+	}
+
+	return rt_tick_get() - start;
+}
+
+void skip_list_conc_bench(int thread_num)
+{
+	int i = 0, n = 0;
+
+	if (thread_num <= 0 || thread_num > SKIP_CONC_BENCH_MAX_THREADS)
+		return;
+
+	sconc_bench_keys = SKIP_CONC_MALLOC(SKIP_CONC_BENCH_KEYS * sizeof(unsigned int));
+	if (sconc_bench_keys == NULL)
+		return;
+	for (i = 0; i < SKIP_CONC_BENCH_KEYS; i++)
+	{
+		sconc_bench_keys[i] = i;
+	}
+
+	for (n = 1; n <= thread_num; n++)
+	{
+		/*skip_list + 全局互斥锁*/
+		sconc_bench_list = NULL;
+		sconc_bench_global_list = skip_list_creat_key(SKIP_CONC_MAX_LEVEL, sizeof(unsigned int), NULL);
+		sconc_bench_global_lock = rt_mutex_create("sconc", RT_IPC_FLAG_PRIO);
+		if (sconc_bench_global_list != NULL && sconc_bench_global_lock != NULL)
+		{
+			for (i = 0; i < SKIP_CONC_BENCH_KEYS; i += 2)
+			{
+				skip_list_insert_key(sconc_bench_global_list, &sconc_bench_keys[i], &sconc_bench_keys[i], 0);
+			}
+			skip_conc_bench_ticks[n - 1][0] = sconc_bench_run(n);
+		}
+		if (sconc_bench_global_list != NULL)
+			skip_list_destroy(sconc_bench_global_list);
+		if (sconc_bench_global_lock != NULL)
+			rt_mutex_delete(sconc_bench_global_lock);
+
+		/*skip_list_conc*/
+		sconc_bench_list = skip_list_conc_creat(SKIP_CONC_MAX_LEVEL, sizeof(unsigned int), NULL);
+		if (sconc_bench_list != NULL)
+		{
+			for (i = 0; i < SKIP_CONC_BENCH_KEYS; i += 2)
+			{
+				skip_list_conc_insert(sconc_bench_list, &sconc_bench_keys[i], &sconc_bench_keys[i]);
+			}
+			skip_conc_bench_ticks[n - 1][1] = sconc_bench_run(n);
+			skip_list_conc_destroy(sconc_bench_list);
+			sconc_bench_list = NULL;
+		}
+	}
+
+	SKIP_CONC_FREE(sconc_bench_keys);
+}
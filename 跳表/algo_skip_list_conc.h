@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 20019-2020, wanweiyingchuang
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     denghengli   the first version
+ * 2026-10-17     denghengli   per-thread epoch counters and level seeds
+ */
+
+#ifndef __ALGO_SKIP_LIST_CONC_H__
+#define __ALGO_SKIP_LIST_CONC_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rtthread.h>
+#include "algo_skip_list.h"
+
+#define SKIP_CONC_MALLOC(size)   rt_malloc(size);
+#define SKIP_CONC_FREE(p)        rt_free(p);
+
+#define SKIP_CONC_MAX_LEVEL      32 /*最大层数*/
+#define SKIP_CONC_SLOT_NUM       16 /*线程槽个数,为2的幂,线程按线程控制块地址分散到各个槽*/
+#define SKIP_CONC_CACHE_LINE     64 /*缓存行大小,每个线程槽独占一个缓存行*/
+
+/*
+ * 原子操作.插入/删除/查找都不加锁,各层next指针的读写和修改都需要原子操作,
+ * 编译器不支持GCC __atomic内建函数时需要替换为平台提供的实现.
+ */
+#define SKIP_CONC_LOAD(p)        __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define SKIP_CONC_STORE(p, v)    __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define SKIP_CONC_LOAD_SC(p)     __atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define SKIP_CONC_LOAD_RLX(p)    __atomic_load_n(p, __ATOMIC_RELAXED)
+#define SKIP_CONC_STORE_RLX(p, v) __atomic_store_n(p, v, __ATOMIC_RELAXED)
+#define SKIP_CONC_ADD(p, v)      __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST)
+#define SKIP_CONC_XCHG(p, v)     __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST)
+#define SKIP_CONC_CAS(p, o, n)   __atomic_compare_exchange_n(p, o, n, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#define SKIP_CONC_FENCE()        __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/*
+ * next指针的最低位为删除标记,标记后该层的next不能再修改.
+ * 第0层的标记是删除的线性化点,标记成功的线程负责把节点从各层中摘除.
+ */
+#define SKIP_CONC_MARK(p)        ((struct skip_conc_node *)((unsigned long)(p) | 1))
+#define SKIP_CONC_UNMARK(p)      ((struct skip_conc_node *)((unsigned long)(p) & ~1UL))
+#define SKIP_CONC_IS_MARKED(p)   (((unsigned long)(p) & 1) != 0)
+
+struct skip_list_conc;
+
+/* key比较,返回值 > 0 : key_cmp > key_becmp, = 0 : 相等, < 0 : key_cmp < key_becmp */
+typedef int (*skip_conc_keycmp)(struct skip_list_conc *list, const void *key_cmp, const void *key_becmp);
+
+/*
+ * 节点和各层next、key数据在一次申请的连续空间中:
+ * | struct skip_conc_node | next[max_level] | key(keysize>0或字符串时) |
+ */
+struct skip_conc_node
+{
+	void *key;                         /*key是唯一的*/
+	void *value;                       /*存储的内容,原子读写*/
+	int max_level;                     /*当前节点最大层数*/
+	int refs;                          /*插入线程和删除线程各持有一个引用,都释放后才放入待回收链表*/
+	struct skip_conc_node *retire_next;/*待回收链表*/
+	struct skip_conc_node *next[];     /*各层下一个节点,最低位为删除标记*/
+};
+
+/*
+ * 线程槽,按缓存行填充.每个线程使用自己所在槽的纪元计数和随机数种子,
+ * 线程之间不会竞争同一个缓存行;多个线程落在同一个槽时仍然正确,只是共享计数和随机序列.
+ */
+struct skip_conc_slot
+{
+	int threads[2];                    /*纪元为奇数/偶数时进入的线程个数*/
+	unsigned int seed;                 /*随机层数的种子(xorshift32),不为0*/
+	char pad[SKIP_CONC_CACHE_LINE - 3 * sizeof(int)];
+};
+
+/*
+ * 无锁并发跳表:
+ * 1、插入先CAS链接第0层(线性化点),再自底向上逐层CAS链接;删除先自顶向下标记各层next,第0层标记成功即删除成功
+ * 2、插入/删除查找时顺便摘除遇到的已标记节点,查找不修改跳表,只跳过已标记节点
+ * 3、节点摘除后放入待回收链表,等所有可能访问它的线程退出后再释放(基于纪元的回收),回收只尝试获取锁,写者不会阻塞
+ * 4、纪元计数和随机层数的种子按线程分散在各个线程槽中,查找和插入不修改共享的计数器
+ */
+struct skip_list_conc
+{
+	int level;   /*当前使用的最大层数,只增不减*/
+	int num;     /*节点数目*/
+	int keysize; /*>0:key为keysize字节的数据,复制到节点内; SKIP_LIST_KEY_STR:字符串; SKIP_LIST_KEY_PTR:只保存指针*/
+	skip_conc_keycmp keycmp; /*key比较*/
+	struct skip_conc_node *head;
+
+	/*纪元与回收*/
+	unsigned int epoch;                    /*当前纪元*/
+	rt_mutex_t reclaim_lock;               /*推进纪元时使用*/
+	struct skip_conc_node *retired[2];     /*对应纪元内摘除的节点*/
+	struct skip_conc_slot slots[SKIP_CONC_SLOT_NUM];
+};
+
+extern struct skip_list_conc* skip_list_conc_creat(int max_level, int keysize, skip_conc_keycmp keycmp);
+extern int skip_list_conc_insert (struct skip_list_conc *list, const void *key, void *value);
+extern int skip_list_conc_delete (struct skip_list_conc *list, const void *key);
+extern int skip_list_conc_modify (struct skip_list_conc *list, const void *key, void *value);
+extern int skip_list_conc_search (struct skip_list_conc *list, const void *key, void **value);
+extern int skip_list_conc_destroy(struct skip_list_conc *list);
+
+/*
+ * 读者区间.skip_list_conc_search返回后节点可能被其他线程删除并释放,
+ * 如果需要在删除的同时继续使用查找到的节点,要在read_lock和read_unlock之间查找并使用.
+ * read_lock的返回值包含线程槽和纪元,要原样传给read_unlock.
+ */
+extern int  skip_list_conc_read_lock(struct skip_list_conc *list);
+extern void skip_list_conc_read_unlock(struct skip_list_conc *list, int idx);
+
+extern void skip_list_conc_bench(int thread_num);
+
+#endif